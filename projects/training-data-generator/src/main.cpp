@@ -5,7 +5,9 @@
 #include <iostream>
 #include <cmath>
 #include <cstdlib>
+#include <string>
 #include <string_view>
+#include <cstdint>
 #include <functional>
 #include <unordered_map>
 
@@ -17,10 +19,10 @@
 
 void printUsage(const char* programName)
 {
-	std::cerr << "Usage 1: " << programName << " and" << std::endl;
-	std::cerr << "Usage 2: " << programName << " or" << std::endl;
-	std::cerr << "Usage 3: " << programName << " no" << std::endl;
-	std::cerr << "Usage 4: " << programName << " xor" << std::endl;
+	std::cerr << "Usage 1: " << programName << " and [TOTAL_SAMPLES]" << std::endl;
+	std::cerr << "Usage 2: " << programName << " or [TOTAL_SAMPLES]" << std::endl;
+	std::cerr << "Usage 3: " << programName << " no [TOTAL_SAMPLES]" << std::endl;
+	std::cerr << "Usage 4: " << programName << " xor [TOTAL_SAMPLES]" << std::endl;
 }
 
 //
@@ -31,24 +33,27 @@ void printUsage(const char* programName)
 
 using outputCallback = std::function<int(int, int)>;
 
-void generateSamples(const outputCallback& callback)
+void generateSamples(const outputCallback& callback, uint64_t totalSamples)
 {
 
 	RandomNumberGenerator rng;
 	rng.ensureRandomSeed();
 
 	std::cout << "topology: 2 4 1" << std::endl;
-	for (int ii = 0; ii < 2000; ++ii)
+	for (uint64_t ii = 0; ii < totalSamples; ++ii)
 	{
 		const int input1 = std::round(rng.getRangedValue(0.0f, 1.0f));
 		const int input2 = std::round(rng.getRangedValue(0.0f, 1.0f));
 
 		const int output = callback(input1, input2); // should be 0 or 1
 
-		std::cout << "in: " << input1 << ".0 " << input2 << ".0 " << std::endl;
-		std::cout << "out: " << output << ".0 " << std::endl;
+		// no flush per line, the benchmarks ask for millions of samples
+		std::cout << "in: " << input1 << ".0 " << input2 << ".0 " << "\n";
+		std::cout << "out: " << output << ".0 " << "\n";
 	}
 
+	std::cout << std::flush;
+
 }
 
 //
@@ -59,7 +64,7 @@ void generateSamples(const outputCallback& callback)
 
 int main(int argc, char** argv)
 {
-	if (argc != 2) {
+	if (argc != 2 && argc != 3) {
 		printUsage(argv[0]);
 		return EXIT_FAILURE;
 	}
@@ -81,7 +86,9 @@ int main(int argc, char** argv)
 
 	const outputCallback callback = it->second;
 
-	generateSamples(callback);
+	const uint64_t totalSamples = (argc == 3) ? std::stoull(argv[2]) : 2000;
+
+	generateSamples(callback, totalSamples);
 
 	return EXIT_SUCCESS;
 }
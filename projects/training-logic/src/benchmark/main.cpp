@@ -0,0 +1,1182 @@
+
+// end-to-end training benchmark
+// -> sweep dataset size, topology width/depth, trainer and thread count,
+//    write the results as JSON and compare them against a stored baseline
+
+
+#include "../machine-learning/NeuralNetwork.hpp"
+#include "../machine-learning/DataParallelTrainer.hpp"
+#include "../machine-learning/PipelinedTrainer.hpp"
+#include "../machine-learning/Gemm.hpp"
+#include "../machine-learning/GemmAutotuner.hpp"
+#include "../machine-learning/StaticNeuralNetwork.hpp"
+#include "../machine-learning/Pruner.hpp"
+#include "../machine-learning/SparseNeuralNetwork.hpp"
+
+#include "../utilities/ISampleSource.hpp"
+#include "../utilities/BinaryFileSampleSource.hpp"
+#include "../utilities/SyntheticGateSampleSource.hpp"
+#include "../utilities/ThreadPool.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <memory>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+
+
+
+
+
+
+
+
+
+
+
+//
+//
+// CONFIG
+
+namespace {
+    const uint32_t k_seed = 0; // every run start from the same weights
+    const uint32_t k_batchSize = 64;
+    const uint32_t k_shardSize = 16;
+    const uint32_t k_minSamplesForError = 100; // same as main.cpp, needed for the average
+    const uint32_t k_maxRepeats = 50; // of a point, whatever its minimum duration
+}
+
+// how the points are trained
+enum class BenchmarkTrainer : uint32_t
+{
+    perSample, // NeuralNetwork::feedForward/backProp, the threads split the wide layers
+    dataParallel, // DataParallelTrainer, the threads split the batch
+    pipeline, // PipelinedTrainer, one stage (thread) per thread count
+};
+
+const char* getTrainerName(BenchmarkTrainer trainer)
+{
+    switch (trainer)
+    {
+        case BenchmarkTrainer::perSample: return "per-sample";
+        case BenchmarkTrainer::dataParallel: return "data-parallel";
+        case BenchmarkTrainer::pipeline: return "pipeline";
+    }
+    return "unknown";
+}
+
+// return false if the name is unknown
+bool getTrainer(const std::string& name, BenchmarkTrainer& trainer)
+{
+    for (BenchmarkTrainer candidate :
+         { BenchmarkTrainer::perSample, BenchmarkTrainer::dataParallel, BenchmarkTrainer::pipeline })
+    {
+        if (name == getTrainerName(candidate))
+        {
+            trainer = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+struct BenchmarkConfig
+{
+    uint64_t minSamples = 1000;
+    uint64_t maxSamples = 100000; // up to 100000000 for the full sweep
+    std::vector<uint32_t> arr_widths = { 4, 32, 128 };
+    std::vector<uint32_t> arr_depths = { 1, 2 };
+    std::vector<uint32_t> arr_threads = { 1, 2, 4 };
+    std::vector<BenchmarkTrainer> arr_trainers = { BenchmarkTrainer::perSample, BenchmarkTrainer::dataParallel };
+
+    double targetError = 0.05;
+    double tolerance = 0.10; // allowed loss of samples/sec against the baseline
+    uint32_t repeats = 3; // runs per point, the median one is kept
+    double minPointSeconds = 0.5; // more runs for the short points
+
+    std::string gate = "xor";
+    std::string source = "text"; // text, binary, synthetic
+    std::string generatorPathname = "../training-data-generator/bin/exec";
+    std::string dataDirectory = "/tmp";
+    std::string outputFilename = "benchmark-results.json";
+    std::string baselineFilename;
+    std::string autotuneFilename; // not empty -> tuned blockings, not deterministic
+
+    uint32_t gemmSize = 0; // > 0 -> blocked vs naive gemm on size^3
+    uint64_t microSamples = 0; // > 0 -> compare the dynamic and static 2 4 1 networks
+    uint64_t latencySamples = 0; // > 0 -> single sample latency of the wide layers, per thread count
+    uint64_t pruningSamples = 0; // > 0 -> dense vs pruned sparse network report
+};
+
+struct BenchmarkResult
+{
+    uint64_t totalSamples = 0;
+    uint32_t width = 0;
+    uint32_t depth = 0;
+    BenchmarkTrainer trainer = BenchmarkTrainer::dataParallel;
+    uint32_t totalThreads = 0; // pipeline -> total stages
+
+    uint32_t totalRuns = 0;
+    double wallSeconds = 0.0; // of the median run
+    double samplesPerSecond = 0.0;
+    long peakRssKb = 0;
+    double timeToTargetSeconds = -1.0; // negative -> target never reached
+    double recentAverageError = 0.0;
+};
+
+// CONFIG
+//
+//
+
+
+
+
+
+
+
+
+
+
+
+
+//
+//
+// RUN
+
+void trainOnePoint(const std::string& dataDescription, double targetError, BenchmarkResult& result)
+{
+    std::unique_ptr<ISampleSource> sampleSource = ISampleSource::create(dataDescription, k_seed);
+
+    std::vector<uint32_t> arr_dataTopology;
+    sampleSource->getTopology(arr_dataTopology);
+
+    // keep the inputs and outputs of the data, replace the hidden layers
+    std::vector<uint32_t> arr_topology;
+    arr_topology.push_back(arr_dataTopology.front());
+    for (uint32_t ii = 0; ii < result.depth; ++ii)
+        arr_topology.push_back(result.width);
+    arr_topology.push_back(arr_dataTopology.back());
+
+    NeuralNetwork myNet(arr_topology, k_seed);
+
+    std::unique_ptr<ThreadPool> threadPool;
+    std::unique_ptr<DataParallelTrainer> dataParallelTrainer;
+    std::unique_ptr<PipelinedTrainer> pipelinedTrainer;
+
+    switch (result.trainer)
+    {
+        case BenchmarkTrainer::perSample:
+            if (result.totalThreads > 1)
+            {
+                threadPool = std::make_unique<ThreadPool>(result.totalThreads);
+                myNet.setThreadPool(threadPool.get());
+            }
+            break;
+
+        case BenchmarkTrainer::dataParallel:
+            threadPool = std::make_unique<ThreadPool>(result.totalThreads);
+            dataParallelTrainer = std::make_unique<DataParallelTrainer>(myNet, *threadPool, k_shardSize);
+            break;
+
+        case BenchmarkTrainer::pipeline:
+            // the shards become the micro-batches
+            pipelinedTrainer = std::make_unique<PipelinedTrainer>(myNet, result.totalThreads, k_shardSize);
+            break;
+    }
+
+    std::vector<t_vals> arr_inputs;
+    std::vector<t_vals> arr_targets;
+
+    uint64_t totalSamples = 0;
+
+    const auto startTime = std::chrono::steady_clock::now();
+    const auto getElapsedSeconds = [&startTime]() -> double {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    };
+
+    for (;;)
+    {
+        // fill a batch, the loading is part of the measure
+        const uint32_t batchSize = sampleSource->getNextBatch(k_batchSize, arr_inputs, arr_targets);
+        if (batchSize == 0)
+            break;
+
+        if (pipelinedTrainer)
+        {
+            pipelinedTrainer->trainBatch(arr_inputs, arr_targets);
+        }
+        else if (dataParallelTrainer)
+        {
+            dataParallelTrainer->trainBatch(arr_inputs, arr_targets);
+        }
+        else
+        {
+            for (uint32_t ii = 0; ii < batchSize; ++ii)
+            {
+                myNet.feedForward(arr_inputs[ii]);
+                myNet.backProp(arr_targets[ii]);
+            }
+        }
+
+        totalSamples += batchSize;
+
+        if (
+            result.timeToTargetSeconds < 0.0 &&
+            totalSamples > k_minSamplesForError &&
+            myNet.getRecentAverageError() < targetError
+        ) {
+            result.timeToTargetSeconds = getElapsedSeconds();
+        }
+    }
+
+    result.wallSeconds = getElapsedSeconds();
+    result.samplesPerSecond = (result.wallSeconds > 0.0) ? (totalSamples / result.wallSeconds) : 0.0;
+    result.recentAverageError = myNet.getRecentAverageError();
+}
+
+// run in a child process -> the peak RSS of the child is the one of this point only
+bool runOnePoint(const std::string& dataDescription, double targetError, BenchmarkResult& result)
+{
+    int fds[2];
+    if (pipe(fds) != 0)
+        return false;
+
+    const pid_t pid = fork();
+    if (pid < 0)
+        return false;
+
+    if (pid == 0)
+    {
+        close(fds[0]);
+
+        trainOnePoint(dataDescription, targetError, result);
+
+        const bool isWritten = (write(fds[1], &result, sizeof(result)) == sizeof(result));
+        close(fds[1]);
+        _exit(isWritten ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    close(fds[1]);
+
+    BenchmarkResult childResult;
+    const bool isRead = (read(fds[0], &childResult, sizeof(childResult)) == sizeof(childResult));
+    close(fds[0]);
+
+    int status = 0;
+    struct rusage usage;
+    if (wait4(pid, &status, 0, &usage) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS || !isRead)
+        return false;
+
+    result = childResult;
+    result.peakRssKb = usage.ru_maxrss; // in KB on Linux
+    return true;
+}
+
+// C[m][n] = op(A)[m][k] * op(B)[k][n], the textbook loops -> the baseline of Gemm::gemm
+void naiveGemm(
+    bool transA, bool transB, uint32_t m, uint32_t n, uint32_t k,
+    const double* A, uint32_t lda, const double* B, uint32_t ldb, double* C, uint32_t ldc)
+{
+    for (uint32_t ii = 0; ii < m; ++ii)
+    for (uint32_t jj = 0; jj < n; ++jj)
+    {
+        double sum = 0.0;
+        for (uint32_t pp = 0; pp < k; ++pp)
+        {
+            const double a = transA ? A[pp * lda + ii] : A[ii * lda + pp];
+            const double b = transB ? B[jj * ldb + pp] : B[pp * ldb + jj];
+            sum += a * b;
+        }
+        C[ii * ldc + jj] = sum;
+    }
+}
+
+// size^3 products, with the transpositions of the layer kernels:
+// naive loops vs Gemm::gemm with the default and the tuned blockings
+void runGemmBenchmark(const BenchmarkConfig& config)
+{
+    const uint32_t size = config.gemmSize;
+
+    std::vector<double> A(std::size_t(size) * size);
+    std::vector<double> B(std::size_t(size) * size);
+    std::vector<double> C(std::size_t(size) * size);
+
+    for (std::size_t ii = 0; ii < A.size(); ++ii)
+        A[ii] = double(ii % 7) * 0.25 - 0.75;
+    for (std::size_t ii = 0; ii < B.size(); ++ii)
+        B[ii] = double(ii % 5) * 0.25 - 0.5;
+
+    const double totalFlops = 2.0 * size * size * size;
+
+    // best of a few runs, repeated for at least 0.1s each
+    const auto measureGflops = [totalFlops](const auto& runGemm) -> double {
+        double bestSeconds = std::numeric_limits<double>::max();
+        for (uint32_t repeat = 0; repeat < 3; ++repeat)
+        {
+            uint32_t totalRuns = 0;
+            double seconds = 0.0;
+            const auto startTime = std::chrono::steady_clock::now();
+            do
+            {
+                runGemm();
+                ++totalRuns;
+                seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+            }
+            while (seconds < 0.1);
+
+            bestSeconds = std::min(bestSeconds, seconds / totalRuns);
+        }
+        return totalFlops / bestSeconds * 1e-9;
+    };
+
+    const GemmBlocking defaultBlocking;
+
+    for (const auto& [transA, transB] : { std::pair(false, true), std::pair(true, false), std::pair(false, false) })
+    {
+        const double naiveGflops = measureGflops([&]() {
+            naiveGemm(transA, transB, size, size, size, A.data(), size, B.data(), size, C.data(), size);
+        });
+        const double defaultGflops = measureGflops([&]() {
+            Gemm::gemm(transA, transB, size, size, size, A.data(), size, B.data(), size, 0.0, C.data(), size, defaultBlocking);
+        });
+
+        std::cout
+            << "gemm " << size << "^3 | " << (transA ? "T" : "N") << (transB ? "T" : "N")
+            << " | " << std::fixed << std::setprecision(2)
+            << "naive " << std::setw(6) << naiveGflops << " GFLOP/s"
+            << " | blocked " << std::setw(6) << defaultGflops << " GFLOP/s, x" << (defaultGflops / naiveGflops);
+
+        if (!config.autotuneFilename.empty())
+        {
+            GemmAutotuner autotuner(config.autotuneFilename);
+            autotuner.tune({ { transA, transB, size, size, size } });
+
+            const GemmBlocking& tunedBlocking = Gemm::getBlocking(transA, transB, size, size, size);
+            const double tunedGflops = measureGflops([&]() {
+                Gemm::gemm(transA, transB, size, size, size, A.data(), size, B.data(), size, 0.0, C.data(), size, tunedBlocking);
+            });
+
+            std::cout
+                << " | tuned " << tunedBlocking.mc << "/" << tunedBlocking.kc << "/" << tunedBlocking.nc
+                << " " << std::setw(6) << tunedGflops << " GFLOP/s, x" << (tunedGflops / naiveGflops);
+        }
+
+        std::cout << std::endl;
+    }
+}
+
+// run the point at least config.repeats times and for config.minPointSeconds,
+// keep the median run -> one slow run (noisy neighbour, page cache) is not a regression
+bool runRepeatedPoint(
+    const BenchmarkConfig& config, const std::string& dataDescription, BenchmarkResult& result)
+{
+    std::vector<BenchmarkResult> arr_runs;
+    double totalSeconds = 0.0;
+    long peakRssKb = 0;
+
+    while (arr_runs.size() < k_maxRepeats &&
+           (arr_runs.size() < config.repeats || totalSeconds < config.minPointSeconds))
+    {
+        BenchmarkResult run = result;
+        if (!runOnePoint(dataDescription, config.targetError, run))
+            return false;
+
+        totalSeconds += run.wallSeconds;
+        peakRssKb = std::max(peakRssKb, run.peakRssKb);
+        arr_runs.push_back(run);
+    }
+
+    std::sort(arr_runs.begin(), arr_runs.end(), [](const BenchmarkResult& lhs, const BenchmarkResult& rhs) {
+        return lhs.wallSeconds < rhs.wallSeconds;
+    });
+
+    result = arr_runs[arr_runs.size() / 2];
+    result.totalRuns = uint32_t(arr_runs.size());
+    result.peakRssKb = peakRssKb;
+    return true;
+}
+
+// the gate networks: dynamic vs compile-time topology, trained on the same samples
+void runMicroNetworkBenchmark(uint64_t totalSamples)
+{
+    NeuralNetwork dynamicNet({ 2, 4, 1 }, k_seed);
+    StaticNeuralNetwork<2, 4, 1> staticNet(dynamicNet);
+
+    const auto getSeconds = [](const auto& startTime) -> double {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    };
+
+    t_vals arr_inputVals(2);
+    t_vals arr_targetVals(1);
+
+    const auto dynamicStart = std::chrono::steady_clock::now();
+    for (uint64_t ii = 0; ii < totalSamples; ++ii)
+    {
+        arr_inputVals[0] = double(ii & 1);
+        arr_inputVals[1] = double((ii >> 1) & 1);
+        arr_targetVals[0] = double((ii & 1) ^ ((ii >> 1) & 1));
+
+        dynamicNet.feedForward(arr_inputVals);
+        dynamicNet.backProp(arr_targetVals);
+    }
+    const double dynamicSeconds = getSeconds(dynamicStart);
+
+    std::array<double, 2> arr_staticInputs;
+    std::array<double, 1> arr_staticTargets;
+
+    const auto staticStart = std::chrono::steady_clock::now();
+    for (uint64_t ii = 0; ii < totalSamples; ++ii)
+    {
+        arr_staticInputs[0] = double(ii & 1);
+        arr_staticInputs[1] = double((ii >> 1) & 1);
+        arr_staticTargets[0] = double((ii & 1) ^ ((ii >> 1) & 1));
+
+        staticNet.feedForward(arr_staticInputs);
+        staticNet.backProp(arr_staticTargets);
+    }
+    const double staticSeconds = getSeconds(staticStart);
+
+    std::cout
+        << "micro networks 2 4 1 | " << totalSamples << " samples"
+        << std::fixed << std::setprecision(0)
+        << " | dynamic " << (totalSamples / dynamicSeconds) << " samples/s"
+        << " | static " << (totalSamples / staticSeconds) << " samples/s"
+        << " | same error: " << (dynamicNet.getRecentAverageError() == staticNet.getRecentAverageError() ? "yes" : "no")
+        << std::endl;
+}
+
+// one sample at a time (NeuralNetwork::feedForward/backProp), the thread pool
+// splits the neurons of each wide layer -> latency of a single sample
+void runLatencyBenchmark(const BenchmarkConfig& config)
+{
+    t_vals arr_inputVals(2);
+    t_vals arr_targetVals(1);
+
+    // per sample, in microseconds
+    const auto measureLatency = [&](NeuralNetwork& myNet) -> double {
+        const auto trainSample = [&](uint64_t ii) {
+            arr_inputVals[0] = double(ii & 1);
+            arr_inputVals[1] = double((ii >> 1) & 1);
+            arr_targetVals[0] = double((ii & 1) ^ ((ii >> 1) & 1));
+
+            myNet.feedForward(arr_inputVals);
+            myNet.backProp(arr_targetVals);
+        };
+
+        // warm-up, the pool threads and the caches
+        for (uint64_t ii = 0; ii < config.latencySamples / 10 + 1; ++ii)
+            trainSample(ii);
+
+        const auto startTime = std::chrono::steady_clock::now();
+        for (uint64_t ii = 0; ii < config.latencySamples; ++ii)
+            trainSample(ii);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+        return seconds * 1e6 / double(config.latencySamples);
+    };
+
+    const uint32_t minParallelWork = NeuralNetwork::getMinParallelWork();
+
+    // smallest layer (connections) where the pool won, per thread count
+    std::vector<uint64_t> arr_breakEvens(config.arr_threads.size(), 0);
+
+    std::vector<uint32_t> arr_widths = config.arr_widths;
+    std::sort(arr_widths.begin(), arr_widths.end());
+
+    for (uint32_t width : arr_widths)
+    {
+        const std::vector<uint32_t> arr_topology = { 2, width, width, 1 };
+        const uint64_t layerConnections = uint64_t(width) * (width + 1);
+
+        NeuralNetwork serialNet(arr_topology, k_seed);
+        const double serialMicroseconds = measureLatency(serialNet);
+
+        for (uint32_t ii = 0; ii < config.arr_threads.size(); ++ii)
+        {
+            const uint32_t totalThreads = config.arr_threads[ii];
+            if (totalThreads < 2)
+                continue;
+
+            ThreadPool threadPool(totalThreads);
+
+            // every layer split, whatever its size -> where the split starts to pay
+            NeuralNetwork::setMinParallelWork(0);
+            NeuralNetwork parallelNet(arr_topology, k_seed);
+            parallelNet.setThreadPool(&threadPool);
+            const double parallelMicroseconds = measureLatency(parallelNet);
+            NeuralNetwork::setMinParallelWork(minParallelWork);
+
+            std::cout
+                << "latency 2 " << width << " " << width << " 1"
+                << " | threads " << std::setw(2) << totalThreads
+                << " | " << std::fixed << std::setprecision(2)
+                << "serial " << std::setw(9) << serialMicroseconds << " us/sample"
+                << " | parallel " << std::setw(9) << parallelMicroseconds << " us/sample"
+                << " | x" << (serialMicroseconds / parallelMicroseconds)
+                << std::endl;
+
+            if (parallelMicroseconds < serialMicroseconds && arr_breakEvens[ii] == 0)
+                arr_breakEvens[ii] = layerConnections;
+        }
+    }
+
+    for (uint32_t ii = 0; ii < config.arr_threads.size(); ++ii)
+    {
+        if (config.arr_threads[ii] < 2)
+            continue;
+
+        std::cout << "latency threads " << config.arr_threads[ii] << " | split pays off from: ";
+        if (arr_breakEvens[ii] == 0)
+            std::cout << "never in these widths";
+        else
+            std::cout << arr_breakEvens[ii] << " connections per layer";
+        std::cout << " (--min-parallel-work, now " << minParallelWork << ")" << std::endl;
+    }
+}
+
+namespace {
+    const double k_arr_sparsities[] = { 0.5, 0.8, 0.9, 0.95 };
+    const uint32_t k_totalTestSamples = 1000;
+    const uint32_t k_inferenceRepeats = 20;
+}
+
+// mean RMS error over the test samples, forward is (inputs, results)
+template <typename t_Forward>
+double evaluateError(
+    const std::vector<t_vals>& arr_inputs, const std::vector<t_vals>& arr_targets, t_Forward forward)
+{
+    t_vals arr_resultVals;
+
+    double totalError = 0.0;
+    for (uint32_t ii = 0; ii < arr_inputs.size(); ++ii)
+    {
+        forward(arr_inputs[ii], arr_resultVals);
+        totalError += DenseLayerKernels::calcSampleError(
+            arr_resultVals.data(), arr_targets[ii].data(), uint32_t(arr_resultVals.size()));
+    }
+
+    return totalError / double(arr_inputs.size());
+}
+
+// inference time of one sample, in microseconds
+template <typename t_Forward>
+double measureInference(const std::vector<t_vals>& arr_inputs, t_Forward forward)
+{
+    t_vals arr_resultVals;
+
+    const auto startTime = std::chrono::steady_clock::now();
+    for (uint32_t rr = 0; rr < k_inferenceRepeats; ++rr)
+    {
+        for (const t_vals& arr_inputVals : arr_inputs)
+            forward(arr_inputVals, arr_resultVals);
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    return seconds * 1e6 / double(k_inferenceRepeats * arr_inputs.size());
+}
+
+// train on pruningSamples, then:
+// -> dense: train on pruningSamples more, the reference
+// and for each sparsity:
+// -> one-shot: prune the dense weights
+// -> iterative: prune gradually while training on the same pruningSamples more
+// -> every network saw the same samples, only the pruning differs
+// and compare the sparse (CSR) inference of the iterative one to the dense kernels
+void runPruningReport(const BenchmarkConfig& config)
+{
+    const uint32_t width = *std::max_element(config.arr_widths.begin(), config.arr_widths.end());
+    const uint32_t depth = *std::max_element(config.arr_depths.begin(), config.arr_depths.end());
+
+    std::vector<uint32_t> arr_topology;
+    arr_topology.push_back(2);
+    for (uint32_t ii = 0; ii < depth; ++ii)
+        arr_topology.push_back(width);
+    arr_topology.push_back(1);
+
+    NeuralNetwork myNet(arr_topology, k_seed);
+    ThreadPool threadPool(1);
+    DataParallelTrainer trainer(myNet, threadPool, k_shardSize);
+
+    std::vector<t_vals> arr_inputs;
+    std::vector<t_vals> arr_targets;
+
+    const auto train = [&](uint64_t totalSamples, uint32_t seed, Pruner* pPruner, double finalSparsity) {
+        SyntheticGateSampleSource sampleSource(config.gate, 2, totalSamples, seed);
+
+        const uint32_t totalSteps = uint32_t((totalSamples + k_batchSize - 1) / k_batchSize);
+        const uint32_t rampSteps = totalSteps / 2; // leave the second half to recover
+
+        for (uint32_t step = 0; sampleSource.getNextBatch(k_batchSize, arr_inputs, arr_targets) > 0; ++step)
+        {
+            if (pPruner)
+                pPruner->pruneToSparsity(Pruner::getScheduledSparsity(finalSparsity, step, rampSteps));
+
+            trainer.trainBatch(arr_inputs, arr_targets);
+
+            if (pPruner)
+                pPruner->applyMask();
+        }
+    };
+
+    train(config.pruningSamples, k_seed, nullptr, 0.0);
+
+    // where the iterative pruning starts from
+    t_vals arr_trainedWeights;
+    myNet.getWeights(arr_trainedWeights);
+
+    // as many samples as the iterative pruning, without pruning
+    train(config.pruningSamples, k_seed + 2, nullptr, 0.0);
+
+    t_vals arr_denseWeights;
+    myNet.getWeights(arr_denseWeights);
+
+    // test samples, never trained on
+    std::vector<t_vals> arr_testInputs;
+    std::vector<t_vals> arr_testTargets;
+    SyntheticGateSampleSource testSource(config.gate, 2, k_totalTestSamples, k_seed + 1);
+    testSource.getNextBatch(k_totalTestSamples, arr_testInputs, arr_testTargets);
+
+    // the reference for the errors
+    const auto networkForward = [&myNet](const t_vals& arr_inputVals, t_vals& arr_resultVals) {
+        myNet.feedForward(arr_inputVals);
+        myNet.getResults(arr_resultVals);
+    };
+
+    // the fastest dense inference -> the baseline of the sparse one
+    DenseLayerShapes arr_shapes;
+    makeDenseLayerShapes(arr_topology, arr_shapes);
+
+    std::vector<t_vals> arr_activations(arr_topology.size());
+    for (uint32_t ii = 0; ii < arr_topology.size(); ++ii)
+        arr_activations[ii].resize(arr_topology[ii]);
+
+    const auto denseForward = [&](const t_vals& arr_inputVals, t_vals& arr_resultVals) {
+        arr_activations.front() = arr_inputVals;
+        for (uint32_t ii = 0; ii < arr_shapes.size(); ++ii)
+        {
+            DenseLayerKernels::feedForward(
+                arr_shapes[ii], arr_denseWeights.data() + arr_shapes[ii].offset,
+                arr_activations[ii].data(), 1, arr_activations[ii + 1].data());
+        }
+        arr_resultVals = arr_activations.back();
+    };
+
+    const double denseError = evaluateError(arr_testInputs, arr_testTargets, networkForward);
+    const double denseMicroseconds = measureInference(arr_testInputs, denseForward);
+    const std::size_t denseBytes = std::size_t(myNet.getTotalWeights()) * sizeof(double);
+
+    std::cout
+        << "pruning";
+    for (uint32_t layerSize : arr_topology)
+        std::cout << " " << layerSize;
+    std::cout
+        << " | " << (2 * config.pruningSamples) << " samples"
+        << " | dense: " << std::fixed << std::setprecision(2) << denseMicroseconds << " us/sample, "
+        << (denseBytes / 1024) << " KB, error " << std::setprecision(4) << denseError
+        << std::endl;
+
+    for (double sparsity : k_arr_sparsities)
+    {
+        // one-shot
+        myNet.setWeights(arr_denseWeights);
+        {
+            Pruner pruner(myNet);
+            pruner.pruneToSparsity(sparsity);
+        }
+        const double oneShotError = evaluateError(arr_testInputs, arr_testTargets, networkForward);
+
+        // iterative, from the same trained weights
+        myNet.setWeights(arr_trainedWeights);
+        Pruner pruner(myNet);
+        train(config.pruningSamples, k_seed + 2, &pruner, sparsity);
+
+        const double iterativeError = evaluateError(arr_testInputs, arr_testTargets, networkForward);
+
+        SparseNeuralNetwork sparseNet(myNet);
+        const auto sparseForward = [&sparseNet](const t_vals& arr_inputVals, t_vals& arr_resultVals) {
+            sparseNet.feedForward(arr_inputVals);
+            sparseNet.getResults(arr_resultVals);
+        };
+
+        const double sparseError = evaluateError(arr_testInputs, arr_testTargets, sparseForward);
+        const double sparseMicroseconds = measureInference(arr_testInputs, sparseForward);
+
+        std::cout
+            << "  sparsity " << std::fixed << std::setprecision(2) << pruner.getSparsity()
+            << " | " << std::setw(9) << sparseNet.getTotalNonZeros() << " non-zeros"
+            << " | " << std::setw(6) << (sparseNet.getMemoryBytes() / 1024) << " KB"
+            << " | sparse " << std::setw(8) << sparseMicroseconds << " us/sample"
+            << " | x" << std::setw(5) << (denseMicroseconds / sparseMicroseconds)
+            << " | error one-shot " << std::setprecision(4) << oneShotError
+            << ", iterative " << iterativeError
+            << (sparseError == iterativeError ? "" : " (sparse mismatch)")
+            << std::endl;
+    }
+}
+
+// RUN
+//
+//
+
+
+
+
+
+
+
+
+
+
+
+
+//
+//
+// JSON
+
+void writeResults(std::ostream& stream, const std::vector<BenchmarkResult>& arr_results)
+{
+    // one result per line -> easy to diff, easy to read back
+    stream << "{\n  \"results\": [\n";
+    for (uint32_t ii = 0; ii < arr_results.size(); ++ii)
+    {
+        const BenchmarkResult& result = arr_results[ii];
+
+        stream
+            << "    { "
+            << "\"samples\": " << result.totalSamples << ", "
+            << "\"width\": " << result.width << ", "
+            << "\"depth\": " << result.depth << ", "
+            << "\"trainer\": \"" << getTrainerName(result.trainer) << "\", "
+            << "\"threads\": " << result.totalThreads << ", "
+            << "\"runs\": " << result.totalRuns << ", "
+            << std::fixed << std::setprecision(6)
+            << "\"wallSeconds\": " << result.wallSeconds << ", "
+            << "\"samplesPerSecond\": " << std::setprecision(1) << result.samplesPerSecond << ", "
+            << "\"peakRssKb\": " << result.peakRssKb << ", "
+            << "\"timeToTargetSeconds\": ";
+
+        if (result.timeToTargetSeconds < 0.0)
+            stream << "null";
+        else
+            stream << std::setprecision(6) << result.timeToTargetSeconds;
+
+        stream
+            << ", \"recentAverageError\": " << std::setprecision(6) << result.recentAverageError
+            << " }" << ((ii + 1 < arr_results.size()) ? "," : "") << "\n";
+    }
+    stream << "  ]\n}\n";
+}
+
+bool readJsonNumber(const std::string& line, const std::string& key, double& value)
+{
+    const std::string pattern = "\"" + key + "\":";
+
+    const std::size_t index = line.find(pattern);
+    if (index == std::string::npos)
+        return false;
+
+    std::stringstream sstr(line.substr(index + pattern.size()));
+    return bool(sstr >> value); // fail on null
+}
+
+bool readJsonString(const std::string& line, const std::string& key, std::string& value)
+{
+    const std::string pattern = "\"" + key + "\": \"";
+
+    const std::size_t index = line.find(pattern);
+    if (index == std::string::npos)
+        return false;
+
+    const std::size_t first = index + pattern.size();
+    const std::size_t last = line.find('"', first);
+    if (last == std::string::npos)
+        return false;
+
+    value = line.substr(first, last - first);
+    return true;
+}
+
+void readResults(const std::string& filename, std::vector<BenchmarkResult>& arr_results)
+{
+    std::ifstream file(filename.c_str());
+    if (file.fail())
+        throw std::invalid_argument("file not found");
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        double samples, width, depth, threads, samplesPerSecond;
+        if (!readJsonNumber(line, "samples", samples) ||
+            !readJsonNumber(line, "width", width) ||
+            !readJsonNumber(line, "depth", depth) ||
+            !readJsonNumber(line, "threads", threads) ||
+            !readJsonNumber(line, "samplesPerSecond", samplesPerSecond))
+            continue;
+
+        BenchmarkResult result;
+        result.totalSamples = uint64_t(samples);
+        result.width = uint32_t(width);
+        result.depth = uint32_t(depth);
+        result.totalThreads = uint32_t(threads);
+
+        // older results have no trainer -> they were all data-parallel
+        std::string trainerName;
+        if (readJsonString(line, "trainer", trainerName) && !getTrainer(trainerName, result.trainer))
+            continue;
+        result.samplesPerSecond = samplesPerSecond;
+        readJsonNumber(line, "wallSeconds", result.wallSeconds);
+        if (!readJsonNumber(line, "timeToTargetSeconds", result.timeToTargetSeconds))
+            result.timeToTargetSeconds = -1.0;
+
+        arr_results.push_back(result);
+    }
+}
+
+// JSON
+//
+//
+
+
+
+
+
+
+
+
+
+
+
+
+//
+//
+// MAIN
+
+void printUsageAndExit(const char* programName)
+{
+    std::cerr
+        << "Usage: " << programName << " [OPTIONS]\n"
+        << "  --min-samples N       smallest dataset (default 1000)\n"
+        << "  --max-samples N       largest dataset, x10 per step (default 100000)\n"
+        << "  --widths A,B,..       hidden layer widths (default 4,32,128)\n"
+        << "  --depths A,B,..       hidden layer counts (default 1,2)\n"
+        << "  --threads A,B,..      thread counts (default 1,2,4)\n"
+        << "  --trainers A,B,..     per-sample, data-parallel, pipeline (default per-sample,data-parallel)\n"
+        << "                        -> pipeline: the thread count is the number of stages\n"
+        << "  --target-error X      for the time to target (default 0.05)\n"
+        << "  --gate NAME           and, or, no, xor (default xor)\n"
+        << "  --source NAME         text, binary, synthetic (default text)\n"
+        << "  --generator PATH      training-data-generator executable\n"
+        << "  --data-dir PATH       where the datasets are generated (default /tmp)\n"
+        << "  --output FILE         JSON results (default benchmark-results.json)\n"
+        << "  --baseline FILE       fail if a run is slower than this baseline\n"
+        << "  --tolerance X         allowed slowdown against the baseline (default 0.10)\n"
+        << "  --repeats N           runs per point, the median one is kept (default 3)\n"
+        << "  --min-point-seconds X more runs until a point took X seconds (default 0.5)\n"
+        << "  --autotune FILE       tune the gemm blockings of the swept layers, cached in FILE\n"
+        << "                        -> faster, but the results differ from one machine to the next\n"
+        << "  --gemm-size N         also compare the blocked and naive gemm on N^3 (e.g. 512)\n"
+        << "  --micro-samples N     also compare the dynamic and static 2 4 1 networks\n"
+        << "  --latency-samples N   also measure the single sample latency of 2 W W 1 networks,\n"
+        << "                        for each width and thread count, serial vs split layers\n"
+        << "  --min-parallel-work N connections under which a layer is not split (default 16384)\n"
+        << "  --pruning-samples N   also report the pruned sparse network speedup and error,\n"
+        << "                        on the largest width and depth\n"
+        << std::endl;
+    exit(EXIT_FAILURE);
+}
+
+// digits only and at most maxValue, otherwise the usage
+uint64_t parseUnsignedOrExit(const char* programName, const std::string& value, uint64_t maxValue = UINT32_MAX)
+{
+    if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos)
+        printUsageAndExit(programName);
+
+    uint64_t result = 0;
+    try
+    {
+        result = std::stoull(value);
+    }
+    catch (const std::out_of_range&)
+    {
+        printUsageAndExit(programName);
+    }
+
+    if (result > maxValue)
+        printUsageAndExit(programName);
+
+    return result;
+}
+
+// the whole value, otherwise the usage
+double parseDoubleOrExit(const char* programName, const std::string& value)
+{
+    std::size_t totalParsed = 0;
+    double result = 0.0;
+    try
+    {
+        result = std::stod(value, &totalParsed);
+    }
+    catch (const std::logic_error&) // invalid_argument, out_of_range
+    {
+        printUsageAndExit(programName);
+    }
+
+    if (totalParsed != value.size())
+        printUsageAndExit(programName);
+
+    return result;
+}
+
+std::vector<uint32_t> parseList(const char* programName, const std::string& value)
+{
+    std::vector<uint32_t> arr_values;
+
+    std::stringstream sstr(value);
+    std::string item;
+    while (std::getline(sstr, item, ','))
+        arr_values.push_back(uint32_t(parseUnsignedOrExit(programName, item)));
+
+    return arr_values;
+}
+
+void parseArguments(int argc, char** argv, BenchmarkConfig& config)
+{
+    for (int ii = 1; ii < argc; ++ii)
+    {
+        const std::string option = argv[ii];
+
+        if (ii + 1 >= argc)
+            printUsageAndExit(argv[0]);
+
+        const std::string value = argv[++ii];
+
+        if (option == "--min-samples") config.minSamples = parseUnsignedOrExit(argv[0], value, UINT64_MAX);
+        else if (option == "--max-samples") config.maxSamples = parseUnsignedOrExit(argv[0], value, UINT64_MAX);
+        else if (option == "--widths") config.arr_widths = parseList(argv[0], value);
+        else if (option == "--depths") config.arr_depths = parseList(argv[0], value);
+        else if (option == "--threads") config.arr_threads = parseList(argv[0], value);
+        else if (option == "--trainers")
+        {
+            config.arr_trainers.clear();
+
+            std::stringstream sstr(value);
+            std::string name;
+            while (std::getline(sstr, name, ','))
+            {
+                BenchmarkTrainer trainer;
+                if (!getTrainer(name, trainer))
+                    printUsageAndExit(argv[0]);
+                config.arr_trainers.push_back(trainer);
+            }
+        }
+        else if (option == "--target-error") config.targetError = parseDoubleOrExit(argv[0], value);
+        else if (option == "--gate") config.gate = value;
+        else if (option == "--source") config.source = value;
+        else if (option == "--generator") config.generatorPathname = value;
+        else if (option == "--data-dir") config.dataDirectory = value;
+        else if (option == "--output") config.outputFilename = value;
+        else if (option == "--baseline") config.baselineFilename = value;
+        else if (option == "--tolerance") config.tolerance = parseDoubleOrExit(argv[0], value);
+        else if (option == "--repeats") config.repeats = uint32_t(parseUnsignedOrExit(argv[0], value));
+        else if (option == "--min-point-seconds") config.minPointSeconds = parseDoubleOrExit(argv[0], value);
+        else if (option == "--autotune") config.autotuneFilename = value;
+        else if (option == "--gemm-size") config.gemmSize = uint32_t(parseUnsignedOrExit(argv[0], value));
+        else if (option == "--micro-samples") config.microSamples = parseUnsignedOrExit(argv[0], value, UINT64_MAX);
+        else if (option == "--latency-samples") config.latencySamples = parseUnsignedOrExit(argv[0], value, UINT64_MAX);
+        else if (option == "--min-parallel-work") NeuralNetwork::setMinParallelWork(uint32_t(parseUnsignedOrExit(argv[0], value)));
+        else if (option == "--pruning-samples") config.pruningSamples = parseUnsignedOrExit(argv[0], value, UINT64_MAX);
+        else printUsageAndExit(argv[0]);
+    }
+
+    if ((config.source != "text" && config.source != "binary" && config.source != "synthetic") ||
+        config.repeats == 0)
+        printUsageAndExit(argv[0]);
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkConfig config;
+    parseArguments(argc, argv, config);
+
+    // the tuned blockings would make the runs differ from one machine to the next
+    Gemm::setDeterministic(config.autotuneFilename.empty());
+
+    if (!config.autotuneFilename.empty())
+    {
+        // before any training thread, the forked points inherit the blockings
+        std::vector<GemmShape> arr_allShapes;
+        std::vector<GemmShape> arr_shapes;
+
+        for (uint32_t width : config.arr_widths)
+        for (uint32_t depth : config.arr_depths)
+        {
+            std::vector<uint32_t> arr_topology(depth + 2, width);
+            arr_topology.front() = 2;
+            arr_topology.back() = 1;
+
+            // the shards of DataParallelTrainer, the micro-batches of PipelinedTrainer
+            GemmAutotuner::getLayerShapes(arr_topology, k_shardSize, arr_shapes);
+            arr_allShapes.insert(arr_allShapes.end(), arr_shapes.begin(), arr_shapes.end());
+        }
+
+        GemmAutotuner autotuner(config.autotuneFilename);
+        autotuner.tune(arr_allShapes);
+        std::cout << "gemm blockings: " << config.autotuneFilename << std::endl;
+    }
+
+    if (config.gemmSize > 0)
+        runGemmBenchmark(config);
+
+    if (config.microSamples > 0)
+        runMicroNetworkBenchmark(config.microSamples);
+
+    if (config.latencySamples > 0)
+        runLatencyBenchmark(config);
+
+    if (config.pruningSamples > 0)
+        runPruningReport(config);
+
+    std::vector<BenchmarkResult> arr_results;
+
+    for (uint64_t totalSamples = config.minSamples; totalSamples <= config.maxSamples; totalSamples *= 10)
+    {
+        const std::string dataFilename =
+            config.dataDirectory + "/benchmark-" + config.gate + "-" + std::to_string(totalSamples);
+
+        // what ISampleSource::create() is given
+        std::string dataDescription;
+
+        if (config.source == "synthetic")
+        {
+            // generated in-process, nothing on disk
+            dataDescription = "synthetic:" + config.gate + ":2:" + std::to_string(totalSamples);
+        }
+        else
+        {
+            const std::string command =
+                config.generatorPathname + " " + config.gate + " " + std::to_string(totalSamples) + " > " + dataFilename + ".txt";
+
+            std::cout << "generating: " << dataFilename << ".txt" << std::endl;
+            if (std::system(command.c_str()) != 0)
+            {
+                std::cerr << "failed to run: " << command << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            dataDescription = dataFilename + ".txt";
+
+            if (config.source == "binary")
+            {
+                {
+                    std::unique_ptr<ISampleSource> textSource = ISampleSource::create(dataDescription, k_seed);
+                    BinaryFileSampleSource::save(*textSource, dataFilename + ".bin");
+                }
+                std::remove(dataDescription.c_str());
+
+                dataDescription = dataFilename + ".bin";
+            }
+        }
+
+        for (uint32_t width : config.arr_widths)
+        for (uint32_t depth : config.arr_depths)
+        for (BenchmarkTrainer trainer : config.arr_trainers)
+        for (uint32_t totalThreads : config.arr_threads)
+        {
+            BenchmarkResult result;
+            result.totalSamples = totalSamples;
+            result.width = width;
+            result.depth = depth;
+            result.trainer = trainer;
+            result.totalThreads = totalThreads;
+
+            if (!runRepeatedPoint(config, dataDescription, result))
+            {
+                std::cerr << "run failed" << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            std::cout
+                << "samples " << std::setw(10) << totalSamples
+                << " | width " << std::setw(5) << width
+                << " | depth " << std::setw(2) << depth
+                << " | " << std::setw(13) << getTrainerName(trainer)
+                << " | threads " << std::setw(2) << totalThreads
+                << " | " << std::fixed << std::setprecision(3) << std::setw(9) << result.wallSeconds << " s"
+                << " | " << std::setprecision(0) << std::setw(10) << result.samplesPerSecond << " samples/s"
+                << " | " << std::setw(8) << result.peakRssKb << " KB"
+                << " | runs " << std::setw(2) << result.totalRuns
+                << std::endl;
+
+            arr_results.push_back(result);
+        }
+
+        if (config.source != "synthetic")
+            std::remove(dataDescription.c_str());
+    }
+
+    {
+        std::ofstream outputFile(config.outputFilename.c_str());
+        writeResults(outputFile, arr_results);
+    }
+    std::cout << "results: " << config.outputFilename << std::endl;
+
+    if (config.baselineFilename.empty())
+        return EXIT_SUCCESS;
+
+    //
+    // compare against the baseline
+
+    std::vector<BenchmarkResult> arr_baseline;
+    readResults(config.baselineFilename, arr_baseline);
+
+    bool hasRegressed = false;
+
+    for (const BenchmarkResult& result : arr_results)
+    {
+        for (const BenchmarkResult& baseline : arr_baseline)
+        {
+            if (baseline.totalSamples != result.totalSamples ||
+                baseline.width != result.width ||
+                baseline.depth != result.depth ||
+                baseline.trainer != result.trainer ||
+                baseline.totalThreads != result.totalThreads)
+                continue;
+
+            const double minSamplesPerSecond = baseline.samplesPerSecond * (1.0 - config.tolerance);
+            if (result.samplesPerSecond < minSamplesPerSecond)
+            {
+                std::cerr
+                    << "REGRESSION: samples " << result.totalSamples
+                    << ", width " << result.width
+                    << ", depth " << result.depth
+                    << ", " << getTrainerName(result.trainer)
+                    << ", threads " << result.totalThreads
+                    << " -> " << std::fixed << std::setprecision(0) << result.samplesPerSecond
+                    << " samples/s, baseline " << baseline.samplesPerSecond << " samples/s"
+                    << std::endl;
+                hasRegressed = true;
+            }
+        }
+    }
+
+    if (hasRegressed)
+        return EXIT_FAILURE;
+
+    std::cout << "no regression against " << config.baselineFilename << std::endl;
+    return EXIT_SUCCESS;
+}
+
+// MAIN
+//
+//
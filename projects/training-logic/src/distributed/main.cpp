@@ -0,0 +1,274 @@
+// distributed data-parallel training
+// -> one process per worker, each one trains on its share of the samples,
+//    kept in sync through a ring all-reduce or a parameter server process
+// -> see sh_distributed.sh to launch several local processes
+
+
+#include "../machine-learning/NeuralNetwork.hpp"
+#include "../machine-learning/DistributedTrainer.hpp"
+#include "../machine-learning/RingAllReduce.hpp"
+#include "../machine-learning/ParameterServer.hpp"
+
+#include "../utilities/ISampleSource.hpp"
+#include "../utilities/ThreadPool.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+
+
+
+
+
+
+
+
+
+
+
+
+//
+//
+// CONFIG
+
+namespace {
+    const uint32_t k_shardSize = 16;
+}
+
+struct DistributedConfig
+{
+    std::string role = "worker"; // worker, server
+    std::string sync = "ring"; // ring, ps
+    uint32_t rank = 0;
+    uint32_t worldSize = 1;
+    std::string address = "unix:/tmp/nn-distributed";
+
+    std::string data = "synthetic:xor:2:100000:0"; // see ISampleSource::create
+    std::vector<uint32_t> arr_hiddenLayers = { 64, 64 };
+    uint32_t batchSize = 64; // per worker
+    uint32_t syncInterval = 1; // batches between two synchronizations
+    uint32_t totalThreads = 1; // per worker
+    uint32_t seed = 0;
+};
+
+// CONFIG
+//
+//
+
+
+
+
+
+
+
+
+
+
+
+
+//
+//
+// RUN
+
+void runWorker(const DistributedConfig& config)
+{
+    std::unique_ptr<ISampleSource> sampleSource = ISampleSource::create(config.data, config.seed);
+
+    // each rank only reads its own shard of the samples
+    if (!sampleSource->setShard(config.rank, config.worldSize))
+        throw std::invalid_argument("cannot split the samples of " + config.data);
+
+    std::vector<uint32_t> arr_dataTopology;
+    sampleSource->getTopology(arr_dataTopology);
+
+    // keep the inputs and outputs of the data, replace the hidden layers
+    std::vector<uint32_t> arr_topology;
+    arr_topology.push_back(arr_dataTopology.front());
+    arr_topology.insert(arr_topology.end(), config.arr_hiddenLayers.begin(), config.arr_hiddenLayers.end());
+    arr_topology.push_back(arr_dataTopology.back());
+
+    NeuralNetwork myNet(arr_topology, config.seed);
+    ThreadPool threadPool(config.totalThreads);
+
+    std::unique_ptr<IAllReduce> allReduce;
+    if (config.sync == "ps")
+        allReduce = std::make_unique<ParameterServerAllReduce>(config.address, config.rank, config.worldSize);
+    else
+        allReduce = std::make_unique<RingAllReduce>(config.address, config.rank, config.worldSize);
+
+    DistributedTrainer trainer(myNet, threadPool, k_shardSize, *allReduce, config.syncInterval);
+    trainer.broadcastWeights();
+
+    std::vector<t_vals> arr_inputs;
+    std::vector<t_vals> arr_targets;
+
+    const auto startTime = std::chrono::steady_clock::now();
+
+    // until every worker is out of samples
+    do
+    {
+        sampleSource->getNextBatch(config.batchSize, arr_inputs, arr_targets);
+    }
+    while (trainer.trainBatch(arr_inputs, arr_targets));
+
+    const uint64_t totalSamples = trainer.getTotalSamples(); // across all the workers
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    if (config.rank != 0)
+        return;
+
+    std::cout
+        << "workers " << config.worldSize
+        << " | " << config.sync
+        << " | sync interval " << config.syncInterval
+        << " | " << totalSamples << " samples"
+        << " | " << std::fixed << std::setprecision(3) << seconds << " s"
+        << " | " << std::setprecision(0) << (seconds > 0.0 ? totalSamples / seconds : 0.0) << " samples/s"
+        << " | recent average error " << std::setprecision(4) << myNet.getRecentAverageError()
+        << std::endl;
+}
+
+// RUN
+//
+//
+
+
+
+
+
+
+
+
+
+
+
+
+//
+//
+// MAIN
+
+void printUsageAndExit(const char* programName)
+{
+    std::cerr
+        << "Usage: " << programName << " [OPTIONS]\n"
+        << "  --role NAME           worker, server (default worker)\n"
+        << "  --sync NAME           ring, ps (default ring), ps needs a server process\n"
+        << "  --rank N              of this worker, [0, world size)\n"
+        << "  --world-size N        number of workers (default 1)\n"
+        << "  --address ADDRESS     unix:PATHNAME or tcp:HOST:PORT (default unix:/tmp/nn-distributed)\n"
+        << "                        -> ring: rank r listens on PATHNAME.r or PORT + r\n"
+        << "  --data DESCRIPTION    text file, *.bin file or synthetic:GATE[:INPUTS[:SAMPLES[:SEED]]]\n"
+        << "                        (default synthetic:xor:2:100000:0), split between the workers\n"
+        << "  --hidden A,B,..       hidden layer sizes (default 64,64)\n"
+        << "  --batch-size N        per worker (default 64)\n"
+        << "  --sync-interval N     batches between two synchronizations (default 1)\n"
+        << "                        -> 1: gradients, each batch, overlapped with the backward pass\n"
+        << "                        -> N: weights averaged every N batches\n"
+        << "  --threads N           per worker (default 1)\n"
+        << "  --seed N              of the initial weights (default 0)\n"
+        << std::endl;
+    exit(EXIT_FAILURE);
+}
+
+// digits only and at most maxValue, otherwise the usage
+uint64_t parseUnsignedOrExit(const char* programName, const std::string& value, uint64_t maxValue = UINT32_MAX)
+{
+    if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos)
+        printUsageAndExit(programName);
+
+    uint64_t result = 0;
+    try
+    {
+        result = std::stoull(value);
+    }
+    catch (const std::out_of_range&)
+    {
+        printUsageAndExit(programName);
+    }
+
+    if (result > maxValue)
+        printUsageAndExit(programName);
+
+    return result;
+}
+
+std::vector<uint32_t> parseList(const char* programName, const std::string& value)
+{
+    std::vector<uint32_t> arr_values;
+
+    std::stringstream sstr(value);
+    std::string item;
+    while (std::getline(sstr, item, ','))
+        arr_values.push_back(uint32_t(parseUnsignedOrExit(programName, item)));
+
+    return arr_values;
+}
+
+void parseArguments(int argc, char** argv, DistributedConfig& config)
+{
+    for (int ii = 1; ii < argc; ++ii)
+    {
+        const std::string option = argv[ii];
+
+        if (ii + 1 >= argc)
+            printUsageAndExit(argv[0]);
+
+        const std::string value = argv[++ii];
+
+        if (option == "--role") config.role = value;
+        else if (option == "--sync") config.sync = value;
+        else if (option == "--rank") config.rank = uint32_t(parseUnsignedOrExit(argv[0], value));
+        else if (option == "--world-size") config.worldSize = uint32_t(parseUnsignedOrExit(argv[0], value));
+        else if (option == "--address") config.address = value;
+        else if (option == "--data") config.data = value;
+        else if (option == "--hidden") config.arr_hiddenLayers = parseList(argv[0], value);
+        else if (option == "--batch-size") config.batchSize = uint32_t(parseUnsignedOrExit(argv[0], value));
+        else if (option == "--sync-interval") config.syncInterval = uint32_t(parseUnsignedOrExit(argv[0], value));
+        else if (option == "--threads") config.totalThreads = uint32_t(parseUnsignedOrExit(argv[0], value));
+        else if (option == "--seed") config.seed = uint32_t(parseUnsignedOrExit(argv[0], value));
+        else printUsageAndExit(argv[0]);
+    }
+
+    if ((config.role != "worker" && config.role != "server") ||
+        (config.sync != "ring" && config.sync != "ps") ||
+        config.worldSize == 0 || config.rank >= config.worldSize ||
+        config.batchSize == 0 || config.syncInterval == 0 || config.totalThreads == 0)
+        printUsageAndExit(argv[0]);
+}
+
+int main(int argc, char** argv)
+{
+    DistributedConfig config;
+    parseArguments(argc, argv, config);
+
+    try
+    {
+        if (config.role == "server")
+        {
+            ParameterServer server(config.address, config.worldSize);
+            const uint64_t totalServed = server.run();
+
+            std::cout << "parameter server: " << totalServed << " all-reduce served" << std::endl;
+        }
+        else
+        {
+            runWorker(config);
+        }
+    }
+    catch (const std::exception& error)
+    {
+        std::cerr << "distributed " << config.role << " " << config.rank << ": " << error.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+// MAIN
+//
+//
@@ -0,0 +1,77 @@
+
+#pragma once
+
+#include <cmath>
+#include <algorithm>
+
+// shared by the per-neuron code and the batched layer kernels
+// #define D_USE_RELU
+
+namespace ActivationFunctions {
+    namespace tanh {
+        inline double activation(double x)
+        {
+            // tanh - output range [-1.0..1.0]
+            return std::tanh(x);
+        }
+
+        inline double derivative(double x)
+        {
+            // tanh derivative
+
+            // faster, less accurate
+            // return 1.0 - x * x;
+
+            return 1.0 - std::tanh(x * x);
+        }
+    }
+
+    namespace relu {
+        inline double activation(double x)
+        {
+            // relu - output range [0.0..1.0]
+            return std::max(x, 0.0);
+        }
+
+        inline double derivative(double x)
+        {
+            // relu derivative
+            // return x < 0.0 ? 0.0 : 1.0;
+            return x < 0.0 ? 0.0 : x;
+        }
+    }
+
+    namespace leakyRelu {
+        inline double activation(double x)
+        {
+            // leaky relu
+            if (x > 0) {
+                return x;
+            }
+            return x * 0.1;
+        }
+
+        inline double derivative(double x)
+        {
+            // leaky relu derivative
+            return x < 0.1 ? 0.0 : x;
+        }
+    }
+
+    // the activation used by the hidden and output neurons
+#ifndef D_USE_RELU
+    namespace current = tanh;
+#else
+    namespace current = leakyRelu;
+#endif
+
+    // gradient of an output neuron, see Neuron::calcOutputGradients
+    inline double outputGradient(double outputVal, double targetVal)
+    {
+#ifndef D_USE_RELU
+        return (targetVal - outputVal) * tanh::derivative(outputVal);
+#else
+        return 2.0 * (outputVal - targetVal);
+#endif
+    }
+}
@@ -0,0 +1,268 @@
+
+#include "Checkpointer.hpp"
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+    const char k_magic[8] = { 'N', 'N', 'C', 'K', 'P', 'T', '0', '2' };
+
+    // a serialized std::mt19937 is ~7KB of text, anything bigger is a corrupted file
+    const uint32_t k_maxRngStateSize = 64 * 1024;
+
+    bool writeAll(int fd, const void* data, std::size_t size)
+    {
+        const char* bytes = static_cast<const char*>(data);
+
+        while (size > 0)
+        {
+            const ssize_t written = ::write(fd, bytes, size);
+            if (written <= 0)
+                return false;
+
+            bytes += written;
+            size -= std::size_t(written);
+        }
+        return true;
+    }
+
+    template <typename T>
+    bool writeValue(int fd, const T& value)
+    {
+        return writeAll(fd, &value, sizeof(T));
+    }
+
+    template <typename T>
+    bool readValue(std::ifstream& file, T& value)
+    {
+        return bool(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+    // what is left to read -> the sizes read from the file can't ask for more than that
+    uint64_t getRemainingBytes(std::ifstream& file)
+    {
+        const std::streampos position = file.tellg();
+        file.seekg(0, std::ios::end);
+        const std::streampos end = file.tellg();
+        file.seekg(position);
+
+        return (position < 0 || end < position) ? 0 : uint64_t(end - position);
+    }
+
+    std::string getDirectory(const std::string& filename)
+    {
+        const std::size_t index = filename.find_last_of('/');
+        return (index == std::string::npos) ? "." : filename.substr(0, index + 1);
+    }
+}
+
+Checkpointer::Checkpointer(const std::string& filename)
+    :   m_filename(filename)
+{
+    m_writerThread = std::thread(&Checkpointer::_runWriter, this);
+}
+
+Checkpointer::~Checkpointer()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_condition.notify_all();
+
+    m_writerThread.join();
+}
+
+void Checkpointer::requestSave(const NeuralNetwork& network, uint64_t dataPosition, uint32_t dataSeed, uint64_t trainingPass)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    // the buffer not being written, the writer can't pick it while we hold the lock
+    const int32_t freeIndex = (m_writingIndex == 0) ? 1 : 0;
+
+    CheckpointState& state = m_arr_states[freeIndex];
+
+    // capacity is kept from one snapshot to the next -> only copies
+    network.getTopology(state.arr_topology);
+    network.getWeights(state.arr_weights);
+    network.getDeltaWeights(state.arr_deltaWeights);
+    state.seed = network.getSeed();
+    state.error = network.getError();
+    state.recentAvgError = network.getRecentAverageError();
+    state.rngState = network.getRandomNumberGenerator().getState();
+    state.dataPosition = dataPosition;
+    state.dataSeed = dataSeed;
+    state.trainingPass = trainingPass;
+
+    m_pendingIndex = freeIndex;
+
+    lock.unlock();
+    m_condition.notify_all();
+}
+
+void Checkpointer::waitIdle()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this]() { return m_pendingIndex < 0 && m_writingIndex < 0; });
+}
+
+bool Checkpointer::load(const std::string& filename, CheckpointState& state)
+{
+    std::ifstream file(filename.c_str(), std::ios::binary);
+    if (file.fail())
+        return false;
+
+    char magic[sizeof(k_magic)];
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, k_magic, sizeof(k_magic)) != 0)
+        return false;
+
+    uint32_t totalLayers = 0;
+    if (!readValue(file, totalLayers) ||
+        totalLayers < 2 ||
+        uint64_t(totalLayers) * sizeof(uint32_t) > getRemainingBytes(file))
+        return false;
+
+    state.arr_topology.resize(totalLayers);
+    for (uint32_t& layerSize : state.arr_topology)
+    {
+        if (!readValue(file, layerSize))
+            return false;
+    }
+
+    uint32_t rngStateSize = 0;
+    uint64_t totalWeights = 0;
+
+    if (!readValue(file, state.seed) ||
+        !readValue(file, state.error) ||
+        !readValue(file, state.recentAvgError) ||
+        !readValue(file, state.dataPosition) ||
+        !readValue(file, state.dataSeed) ||
+        !readValue(file, state.trainingPass) ||
+        !readValue(file, rngStateSize) ||
+        rngStateSize > k_maxRngStateSize ||
+        rngStateSize > getRemainingBytes(file))
+        return false;
+
+    state.rngState.resize(rngStateSize);
+    if (!file.read(state.rngState.data(), rngStateSize) || !readValue(file, totalWeights))
+        return false;
+
+    // the weights must be the ones of the topology, and be in the file (weights + delta weights)
+    const uint64_t maxWeights = getRemainingBytes(file) / (2 * sizeof(double));
+
+    uint64_t expectedWeights = 0;
+    for (uint32_t ii = 1; ii < totalLayers; ++ii)
+    {
+        // (inputs + bias) * outputs, can't overflow from two uint32_t
+        const uint64_t layerWeights = (uint64_t(state.arr_topology[ii - 1]) + 1) * state.arr_topology[ii];
+        if (layerWeights > maxWeights - expectedWeights)
+            return false;
+
+        expectedWeights += layerWeights;
+    }
+
+    if (totalWeights != expectedWeights)
+        return false;
+
+    state.arr_weights.resize(totalWeights);
+    state.arr_deltaWeights.resize(totalWeights);
+
+    const std::streamsize totalBytes = std::streamsize(totalWeights * sizeof(double));
+    return
+        file.read(reinterpret_cast<char*>(state.arr_weights.data()), totalBytes) &&
+        file.read(reinterpret_cast<char*>(state.arr_deltaWeights.data()), totalBytes);
+}
+
+void Checkpointer::restore(const CheckpointState& state, NeuralNetwork& network)
+{
+    std::vector<uint32_t> arr_topology;
+    network.getTopology(arr_topology);
+
+    assert( arr_topology == state.arr_topology ); // build the network from state.arr_topology
+
+    network.setWeights(state.arr_weights);
+    network.setDeltaWeights(state.arr_deltaWeights);
+    network.setErrors(state.error, state.recentAvgError);
+    network.getRandomNumberGenerator().setState(state.rngState);
+}
+
+void Checkpointer::_runWriter()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    for (;;)
+    {
+        m_condition.wait(lock, [this]() { return m_stop || m_pendingIndex >= 0; });
+
+        if (m_pendingIndex < 0)
+            return; // stop, and nothing left to save
+
+        m_writingIndex = m_pendingIndex;
+        m_pendingIndex = -1;
+
+        // the training thread only touch the other buffer meanwhile
+        lock.unlock();
+        if (!_save(m_arr_states[m_writingIndex]))
+        {
+            std::cerr << "checkpoint: failed to save " << m_filename << std::endl;
+        }
+        lock.lock();
+
+        m_writingIndex = -1;
+        m_condition.notify_all();
+    }
+}
+
+bool Checkpointer::_save(const CheckpointState& state) const
+{
+    const std::string tmpFilename = m_filename + ".tmp";
+
+    const int fd = ::open(tmpFilename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        return false;
+
+    const uint32_t totalLayers = uint32_t(state.arr_topology.size());
+    const uint32_t rngStateSize = uint32_t(state.rngState.size());
+    const uint64_t totalWeights = state.arr_weights.size();
+
+    const bool isWritten =
+        writeAll(fd, k_magic, sizeof(k_magic)) &&
+        writeValue(fd, totalLayers) &&
+        writeAll(fd, state.arr_topology.data(), totalLayers * sizeof(uint32_t)) &&
+        writeValue(fd, state.seed) &&
+        writeValue(fd, state.error) &&
+        writeValue(fd, state.recentAvgError) &&
+        writeValue(fd, state.dataPosition) &&
+        writeValue(fd, state.dataSeed) &&
+        writeValue(fd, state.trainingPass) &&
+        writeValue(fd, rngStateSize) &&
+        writeAll(fd, state.rngState.data(), rngStateSize) &&
+        writeValue(fd, totalWeights) &&
+        writeAll(fd, state.arr_weights.data(), totalWeights * sizeof(double)) &&
+        writeAll(fd, state.arr_deltaWeights.data(), totalWeights * sizeof(double)) &&
+        ::fsync(fd) == 0;
+
+    ::close(fd);
+
+    if (!isWritten || std::rename(tmpFilename.c_str(), m_filename.c_str()) != 0)
+    {
+        std::remove(tmpFilename.c_str());
+        return false;
+    }
+
+    // make the rename itself durable
+    const int dirFd = ::open(getDirectory(m_filename).c_str(), O_RDONLY | O_DIRECTORY);
+    if (dirFd >= 0)
+    {
+        ::fsync(dirFd);
+        ::close(dirFd);
+    }
+
+    return true;
+}
@@ -0,0 +1,78 @@
+
+#pragma once
+
+#include "./NeuralNetwork.hpp"
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+//
+//
+// CHECKPOINTER
+
+// everything needed to resume a training with the exact same state
+struct CheckpointState
+{
+    std::vector<uint32_t> arr_topology;
+    uint32_t seed = 0;
+    t_vals arr_weights;
+    t_vals arr_deltaWeights; // optimizer state
+    double error = 0.0;
+    double recentAvgError = 0.0;
+    std::string rngState;
+
+    // data loader
+    uint64_t dataPosition = 0; // see ISampleSource::getPosition
+    uint32_t dataSeed = 0; // see ISampleSource::getSeed
+    uint64_t trainingPass = 0;
+};
+
+// Periodic checkpoints, saved off the training thread.
+//
+// requestSave() only copies the state in the free half of a double buffer,
+// a background thread then serializes it to a temporary file, fsync it and
+// rename it over the previous checkpoint -> a crash at any point leaves the
+// latest complete checkpoint on disk.
+
+class Checkpointer
+{
+private: // attr
+    std::string m_filename;
+
+    CheckpointState m_arr_states[2];
+    int32_t m_writingIndex = -1; // buffer being saved, -1 -> none
+    int32_t m_pendingIndex = -1; // buffer waiting to be saved, -1 -> none
+    bool m_stop = false;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::thread m_writerThread;
+
+public: // ctor/dtor
+    Checkpointer(const std::string& filename);
+    ~Checkpointer(); // finish the pending save
+
+    Checkpointer(const Checkpointer& other) = delete;
+    Checkpointer& operator=(const Checkpointer& other) = delete;
+
+public: // public method(s)
+    // copy the state and return, a save still pending is replaced by this newer one
+    void requestSave(const NeuralNetwork& network, uint64_t dataPosition, uint32_t dataSeed, uint64_t trainingPass);
+
+    // block until nothing is left to save
+    void waitIdle();
+
+public: // static method(s)
+    static bool load(const std::string& filename, CheckpointState& state);
+    static void restore(const CheckpointState& state, NeuralNetwork& network);
+
+private: // private method(s)
+    void _runWriter();
+    bool _save(const CheckpointState& state) const;
+};
+
+// CHECKPOINTER
+//
+//
@@ -0,0 +1,220 @@
+
+#include "DataParallelTrainer.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+DataParallelTrainer::DataParallelTrainer(NeuralNetwork& network, ThreadPool& threadPool, uint32_t shardSize)
+    :   m_network(network),
+        m_threadPool(threadPool),
+        m_shardSize(shardSize)
+{
+    assert( shardSize > 0 );
+
+    std::vector<uint32_t> arr_topology;
+    m_network.getTopology(arr_topology);
+    makeDenseLayerShapes(arr_topology, m_arr_shapes);
+}
+
+void DataParallelTrainer::trainBatch(const std::vector<t_vals>& arr_inputs, const std::vector<t_vals>& arr_targets)
+{
+    if (arr_inputs.empty())
+        return;
+
+    computeGradients(arr_inputs, arr_targets, m_arr_batchGradients);
+    applyGradients(m_arr_batchGradients, uint32_t(arr_inputs.size()));
+}
+
+void DataParallelTrainer::computeGradients(
+    const std::vector<t_vals>& arr_inputs, const std::vector<t_vals>& arr_targets,
+    t_vals& arr_gradients, const t_onLayerReady& onLayerReady)
+{
+    assert( arr_inputs.size() == arr_targets.size() );
+
+    const uint32_t totalSamples = uint32_t(arr_inputs.size());
+    const uint32_t totalWeights = m_network.getTotalWeights();
+    const uint32_t totalLayers = uint32_t(m_arr_shapes.size());
+
+    if (totalSamples == 0)
+    {
+        arr_gradients.assign(totalWeights, 0.0);
+
+        // still one call per layer, the callers may count on them
+        if (onLayerReady)
+        {
+            for (uint32_t ii = totalLayers; ii > 0; --ii)
+                onLayerReady(m_arr_shapes[ii - 1], arr_gradients.data() + m_arr_shapes[ii - 1].offset);
+        }
+        return;
+    }
+
+    m_network.getWeights(m_arr_weights);
+
+    const uint32_t totalShards = (totalSamples + m_shardSize - 1) / m_shardSize;
+    if (m_arr_shards.size() < totalShards)
+        m_arr_shards.resize(totalShards);
+
+    m_arr_errors.assign(totalSamples, 0.0);
+
+    const auto getShardSize = [this, totalSamples](uint32_t shardIndex) -> uint32_t {
+        const uint32_t firstSample = shardIndex * m_shardSize;
+        return std::min(firstSample + m_shardSize, totalSamples) - firstSample;
+    };
+
+    m_threadPool.parallelFor(totalShards, [&](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t ii = begin; ii < end; ++ii)
+        {
+            const uint32_t firstSample = ii * m_shardSize;
+
+            _forwardShard(m_arr_shards[ii], arr_inputs, arr_targets, firstSample, firstSample + getShardSize(ii));
+        }
+    });
+
+    // the weight gradients end up in the first shard
+    double* gradients = m_arr_shards.front().arr_weightGradients.data();
+
+    for (uint32_t layerIndex = totalLayers; layerIndex > 0; --layerIndex)
+    {
+        const DenseLayerShape& shape = m_arr_shapes[layerIndex - 1];
+
+        m_threadPool.parallelFor(totalShards, [&](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t ii = begin; ii < end; ++ii)
+                _backwardShard(m_arr_shards[ii], layerIndex - 1, getShardSize(ii));
+        });
+
+        _reduceShards(totalShards, shape);
+
+        if (onLayerReady)
+            onLayerReady(shape, gradients + shape.offset);
+    }
+
+    // the buffers are exchanged, not copied -> "gradients" stays valid
+    arr_gradients.swap(m_arr_shards.front().arr_weightGradients);
+
+    // in sample order, whatever thread computed them
+    for (double error : m_arr_errors)
+    {
+        m_network.recordError(error);
+    }
+}
+
+void DataParallelTrainer::applyGradients(const t_vals& arr_gradients, uint32_t totalSamples)
+{
+    assert( totalSamples > 0 );
+
+    m_network.getWeights(m_arr_weights);
+
+    assert( arr_gradients.size() == m_arr_weights.size() );
+
+    m_arr_deltaWeights.resize(m_arr_weights.size());
+
+    DenseLayerKernels::applyWeightGradients(
+        arr_gradients.data(), uint32_t(arr_gradients.size()),
+        1.0 / totalSamples, m_arr_weights.data(), m_arr_deltaWeights.data());
+
+    m_network.setWeights(m_arr_weights);
+    m_network.setDeltaWeights(m_arr_deltaWeights);
+}
+
+void DataParallelTrainer::_forwardShard(
+    Shard& shard,
+    const std::vector<t_vals>& arr_inputs, const std::vector<t_vals>& arr_targets,
+    uint32_t firstSample, uint32_t lastSample)
+{
+    const uint32_t batchSize = lastSample - firstSample;
+    const uint32_t totalLayers = uint32_t(m_arr_shapes.size());
+    const uint32_t numOutputs = m_arr_shapes.back().numOutputs;
+
+    shard.arr_weightGradients.assign(m_arr_weights.size(), 0.0);
+    shard.arr_activations.resize(totalLayers + 1);
+
+    //
+    // forward
+
+    t_vals& inputs = shard.arr_activations[0];
+    inputs.clear();
+    for (uint32_t ii = firstSample; ii < lastSample; ++ii)
+    {
+        assert( arr_inputs[ii].size() == m_arr_shapes.front().numInputs );
+
+        inputs.insert(inputs.end(), arr_inputs[ii].begin(), arr_inputs[ii].end());
+    }
+
+    for (uint32_t ii = 0; ii < totalLayers; ++ii)
+    {
+        const DenseLayerShape& shape = m_arr_shapes[ii];
+
+        shard.arr_activations[ii + 1].resize(batchSize * shape.numOutputs);
+
+        DenseLayerKernels::feedForward(
+            shape, m_arr_weights.data() + shape.offset,
+            shard.arr_activations[ii].data(), batchSize, shard.arr_activations[ii + 1].data());
+    }
+
+    //
+    // error and output gradients
+
+    const t_vals& outputs = shard.arr_activations.back();
+    shard.arr_gradients.resize(outputs.size());
+
+    for (uint32_t ii = 0; ii < batchSize; ++ii)
+    {
+        const t_vals& targets = arr_targets[firstSample + ii];
+
+        assert( targets.size() == numOutputs );
+
+        const double* sampleOutputs = outputs.data() + ii * numOutputs;
+
+        m_arr_errors[firstSample + ii] = DenseLayerKernels::calcSampleError(sampleOutputs, targets.data(), numOutputs);
+
+        DenseLayerKernels::calcOutputGradients(
+            sampleOutputs, targets.data(), numOutputs, shard.arr_gradients.data() + ii * numOutputs);
+    }
+}
+
+void DataParallelTrainer::_backwardShard(Shard& shard, uint32_t layerIndex, uint32_t batchSize)
+{
+    const DenseLayerShape& shape = m_arr_shapes[layerIndex];
+    const t_vals& layerInputs = shard.arr_activations[layerIndex];
+
+    DenseLayerKernels::accumulateWeightGradients(
+        shape, layerInputs.data(), shard.arr_gradients.data(), batchSize,
+        shard.arr_weightGradients.data() + shape.offset);
+
+    // the input layer has no gradients
+    if (layerIndex == 0)
+        return;
+
+    shard.arr_inputGradients.resize(batchSize * shape.numInputs);
+    DenseLayerKernels::calcHiddenGradients(
+        shape, m_arr_weights.data() + shape.offset,
+        shard.arr_gradients.data(), layerInputs.data(), batchSize,
+        shard.arr_inputGradients.data());
+
+    shard.arr_gradients.swap(shard.arr_inputGradients);
+}
+
+void DataParallelTrainer::_reduceShards(uint32_t totalShards, const DenseLayerShape& shape)
+{
+    // pairwise tree -> (((0 + 1) + (2 + 3)) + ((4 + 5) + ...
+    // each weight is summed in the same order, however the weights are split among the threads
+
+    m_threadPool.parallelFor(shape.getTotalWeights(), [&](uint32_t begin, uint32_t end)
+    {
+        for (uint32_t stride = 1; stride < totalShards; stride *= 2)
+        {
+            for (uint32_t ii = 0; ii + stride < totalShards; ii += 2 * stride)
+            {
+                double* target = m_arr_shards[ii].arr_weightGradients.data() + shape.offset;
+                const double* source = m_arr_shards[ii + stride].arr_weightGradients.data() + shape.offset;
+
+                for (uint32_t jj = begin; jj < end; ++jj)
+                {
+                    target[jj] += source[jj];
+                }
+            }
+        }
+    });
+}
@@ -0,0 +1,88 @@
+
+#pragma once
+
+#include "./NeuralNetwork.hpp"
+#include "./DenseLayers.hpp"
+
+#include "../utilities/ThreadPool.hpp"
+
+#include <functional>
+
+//
+//
+// DATA PARALLEL TRAINER
+
+// Split each batch in shards of a fixed size, the threads of the pool
+// compute the weight gradients of the shards, which are then summed as a
+// pairwise tree in a fixed order.
+//
+// The shards and the reduction order only depend on the shard size, never on
+// the number of threads -> with a seeded network and Gemm::setDeterministic,
+// a run on 1 or 32 threads produces bit-identical weights.
+//
+// The backward pass goes layer by layer over all the shards, so the summed
+// gradients of a layer are ready while the previous layers are still being
+// computed -> a distributed trainer can send them meanwhile.
+
+class DataParallelTrainer
+{
+public: // external structures
+    // the summed gradients of one layer are final, called from the last layer to the first
+    // -> they may be modified in place until computeGradients() returns
+    using t_onLayerReady = std::function<void(const DenseLayerShape& shape, double* layerGradients)>;
+
+private: // internal structures
+    struct Shard
+    {
+        t_vals arr_weightGradients; // same layout as the weights
+        std::vector<t_vals> arr_activations; // inputs, then the outputs of each layer
+        t_vals arr_gradients;
+        t_vals arr_inputGradients;
+    };
+
+private: // attr
+    NeuralNetwork& m_network;
+    ThreadPool& m_threadPool;
+    uint32_t m_shardSize;
+
+    DenseLayerShapes m_arr_shapes;
+    t_vals m_arr_weights;
+    t_vals m_arr_deltaWeights;
+    t_vals m_arr_batchGradients;
+    t_vals m_arr_errors; // per sample
+
+    std::vector<Shard> m_arr_shards;
+
+public: // ctor/dtor
+    DataParallelTrainer(NeuralNetwork& network, ThreadPool& threadPool, uint32_t shardSize);
+
+public: // public method(s)
+    // computeGradients() then applyGradients() with the batch's own gradients
+    void trainBatch(const std::vector<t_vals>& arr_inputs, const std::vector<t_vals>& arr_targets);
+
+    // sum of the weight gradients of the batch (not averaged), same layout as the weights
+    // -> the errors of the samples are recorded in the network
+    void computeGradients(
+        const std::vector<t_vals>& arr_inputs, const std::vector<t_vals>& arr_targets,
+        t_vals& arr_gradients, const t_onLayerReady& onLayerReady = nullptr);
+
+    // apply summed gradients to the network, averaged over totalSamples
+    void applyGradients(const t_vals& arr_gradients, uint32_t totalSamples);
+
+public: // getter/setter
+    inline uint32_t getShardSize(void) const { return m_shardSize; }
+
+private: // private method(s)
+    // forward, errors and output gradients
+    void _forwardShard(
+        Shard& shard,
+        const std::vector<t_vals>& arr_inputs, const std::vector<t_vals>& arr_targets,
+        uint32_t firstSample, uint32_t lastSample);
+    // weight gradients of one layer, then the gradients of its inputs
+    void _backwardShard(Shard& shard, uint32_t layerIndex, uint32_t batchSize);
+    void _reduceShards(uint32_t totalShards, const DenseLayerShape& shape);
+};
+
+// DATA PARALLEL TRAINER
+//
+//
@@ -0,0 +1,154 @@
+
+#include "DenseLayers.hpp"
+
+#include "ActivationFunctions.hpp"
+#include "Gemm.hpp"
+#include "Neuron.hpp"
+
+#include <cassert>
+
+void makeDenseLayerShapes(const std::vector<uint32_t>& arr_topology, DenseLayerShapes& arr_shapes)
+{
+    assert( arr_topology.size() >= 2 ); // need at least an input and an output layer
+
+    arr_shapes.clear();
+    arr_shapes.reserve(arr_topology.size() - 1); // pre-allocate
+
+    uint32_t offset = 0;
+    for (uint32_t ii = 1; ii < arr_topology.size(); ++ii)
+    {
+        DenseLayerShape shape;
+        shape.numInputs = arr_topology[ii - 1];
+        shape.numOutputs = arr_topology[ii];
+        shape.offset = offset;
+
+        arr_shapes.push_back(shape);
+
+        offset += shape.getTotalWeights();
+    }
+}
+
+namespace DenseLayerKernels
+{
+    void feedForward(
+        const DenseLayerShape& shape, const double* weights,
+        const double* inputs, uint32_t batchSize, double* outputs)
+    {
+        const uint32_t rowSize = shape.getRowSize();
+
+        // outputs[batch][out] = inputs[batch][in] * weights[out][in]^T
+        // -> the bias column is skipped by the stride, added below
+        if (batchSize == 1)
+        {
+            Gemm::gemv(false, shape.numOutputs, shape.numInputs, weights, rowSize, inputs, 0.0, outputs);
+        }
+        else
+        {
+            Gemm::gemm(
+                false, true, batchSize, shape.numOutputs, shape.numInputs,
+                inputs, shape.numInputs, weights, rowSize,
+                0.0, outputs, shape.numOutputs);
+        }
+
+        for (uint32_t bb = 0; bb < batchSize; ++bb)
+        {
+            double* sampleOutputs = outputs + bb * shape.numOutputs;
+
+            for (uint32_t jj = 0; jj < shape.numOutputs; ++jj)
+            {
+                // the bias neuron, its output is always 1.0
+                const double sum = sampleOutputs[jj] + weights[jj * rowSize + shape.numInputs];
+
+                sampleOutputs[jj] = ActivationFunctions::current::activation(sum);
+            }
+        }
+    }
+
+    double calcSampleError(const double* outputs, const double* targets, uint32_t numOutputs)
+    {
+        double error = 0.0;
+        for (uint32_t ii = 0; ii < numOutputs; ++ii)
+        {
+            const double delta = targets[ii] - outputs[ii];
+            error += delta * delta;
+        }
+        error /= numOutputs; // get average error squared
+
+        return std::sqrt(error); // RMS
+    }
+
+    void calcOutputGradients(
+        const double* outputs, const double* targets, uint32_t totalValues, double* gradients)
+    {
+        for (uint32_t ii = 0; ii < totalValues; ++ii)
+        {
+            gradients[ii] = ActivationFunctions::outputGradient(outputs[ii], targets[ii]);
+        }
+    }
+
+    void calcHiddenGradients(
+        const DenseLayerShape& shape, const double* weights,
+        const double* gradients, const double* inputs, uint32_t batchSize,
+        double* inputGradients)
+    {
+        const uint32_t rowSize = shape.getRowSize();
+
+        // Sum our contributions of the errors at the nodes we feed.
+        // inputGradients[batch][in] = gradients[batch][out] * weights[out][in]
+        if (batchSize == 1)
+        {
+            Gemm::gemv(true, shape.numInputs, shape.numOutputs, weights, rowSize, gradients, 0.0, inputGradients);
+        }
+        else
+        {
+            Gemm::gemm(
+                false, false, batchSize, shape.numInputs, shape.numOutputs,
+                gradients, shape.numOutputs, weights, rowSize,
+                0.0, inputGradients, shape.numInputs);
+        }
+
+        const uint32_t totalValues = batchSize * shape.numInputs;
+        for (uint32_t ii = 0; ii < totalValues; ++ii)
+        {
+            inputGradients[ii] *= ActivationFunctions::current::derivative(inputs[ii]);
+        }
+    }
+
+    void accumulateWeightGradients(
+        const DenseLayerShape& shape,
+        const double* inputs, const double* gradients, uint32_t batchSize,
+        double* weightGradients)
+    {
+        const uint32_t rowSize = shape.getRowSize();
+
+        // weightGradients[out][in] += gradients[batch][out]^T * inputs[batch][in]
+        Gemm::gemm(
+            true, false, shape.numOutputs, shape.numInputs, batchSize,
+            gradients, shape.numOutputs, inputs, shape.numInputs,
+            1.0, weightGradients, rowSize);
+
+        // bias neuron -> the sum of the gradients
+        for (uint32_t bb = 0; bb < batchSize; ++bb)
+        {
+            const double* sampleGradients = gradients + bb * shape.numOutputs;
+
+            for (uint32_t jj = 0; jj < shape.numOutputs; ++jj)
+            {
+                weightGradients[jj * rowSize + shape.numInputs] += sampleGradients[jj];
+            }
+        }
+    }
+
+    void applyWeightGradients(
+        const double* weightGradients, uint32_t totalWeights, double scale,
+        double* weights, double* deltaWeights)
+    {
+        const double factor = Neuron::getLearningRate() * scale;
+
+        for (uint32_t ii = 0; ii < totalWeights; ++ii)
+        {
+            deltaWeights[ii] = factor * weightGradients[ii];
+            weights[ii] += deltaWeights[ii];
+        }
+    }
+}
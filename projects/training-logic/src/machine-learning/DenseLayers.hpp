@@ -0,0 +1,63 @@
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+//
+//
+// DENSE LAYERS
+
+using t_vals = std::vector<double>;
+
+// Weights between two layers, as a view inside the flat weights of
+// NeuralNetwork::getWeights() -> row-major [numOutputs][numInputs + 1]
+struct DenseLayerShape
+{
+    uint32_t numInputs; // exclude bias neuron
+    uint32_t numOutputs; // exclude bias neuron
+    uint32_t offset; // index of the first weight in the flat weights
+
+    inline uint32_t getRowSize(void) const { return numInputs + 1; }
+    inline uint32_t getTotalWeights(void) const { return numOutputs * (numInputs + 1); }
+};
+using DenseLayerShapes = std::vector<DenseLayerShape>;
+
+void makeDenseLayerShapes(const std::vector<uint32_t>& arr_topology, DenseLayerShapes& arr_shapes);
+
+// Batched version of the Neuron methods, used by the batched trainers.
+// A batch is a row-major matrix [batchSize][numValues], bias neurons excluded.
+namespace DenseLayerKernels
+{
+    void feedForward(
+        const DenseLayerShape& shape, const double* weights,
+        const double* inputs, uint32_t batchSize, double* outputs);
+
+    // return the RMS error of one sample
+    double calcSampleError(const double* outputs, const double* targets, uint32_t numOutputs);
+
+    void calcOutputGradients(
+        const double* outputs, const double* targets, uint32_t totalValues, double* gradients);
+
+    // gradients of the inputs, "inputs" are the outputs of the previous layer
+    void calcHiddenGradients(
+        const DenseLayerShape& shape, const double* weights,
+        const double* gradients, const double* inputs, uint32_t batchSize,
+        double* inputGradients);
+
+    // weightGradients += the contribution of this batch, same layout as the weights
+    void accumulateWeightGradients(
+        const DenseLayerShape& shape,
+        const double* inputs, const double* gradients, uint32_t batchSize,
+        double* weightGradients);
+
+    // weights += learningRate * scale * weightGradients
+    // deltaWeights (same layout) receive the change of each weight
+    void applyWeightGradients(
+        const double* weightGradients, uint32_t totalWeights, double scale,
+        double* weights, double* deltaWeights);
+}
+
+// DENSE LAYERS
+//
+//
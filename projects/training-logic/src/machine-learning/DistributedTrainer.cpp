@@ -0,0 +1,177 @@
+
+#include "DistributedTrainer.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+DistributedTrainer::DistributedTrainer(
+    NeuralNetwork& network, ThreadPool& threadPool, uint32_t shardSize,
+    IAllReduce& allReduce, uint32_t syncInterval)
+    :   m_network(network),
+        m_trainer(network, threadPool, shardSize),
+        m_allReduce(allReduce),
+        m_syncInterval(syncInterval)
+{
+    assert( syncInterval > 0 );
+
+    m_communicationThread = std::thread(&DistributedTrainer::_runCommunication, this);
+}
+
+DistributedTrainer::~DistributedTrainer()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_condition.notify_all();
+
+    m_communicationThread.join();
+}
+
+void DistributedTrainer::broadcastWeights(void)
+{
+    m_network.getWeights(m_arr_weights);
+
+    // sum of the weights of rank 0 and of zeros
+    if (m_allReduce.getRank() != 0)
+        m_arr_weights.assign(m_arr_weights.size(), 0.0);
+
+    m_allReduce.allReduce(m_arr_weights.data(), uint32_t(m_arr_weights.size()));
+
+    m_network.setWeights(m_arr_weights);
+}
+
+bool DistributedTrainer::trainBatch(const std::vector<t_vals>& arr_inputs, const std::vector<t_vals>& arr_targets)
+{
+    // the processes may run out of samples at different batches
+    const uint32_t localSamples = uint32_t(arr_inputs.size());
+
+    if (m_syncInterval == 1)
+    {
+        uint32_t outputLayerOffset = 0;
+        bool isOutputLayer = true;
+
+        // each layer is sent while the backward pass continues on the previous ones
+        m_trainer.computeGradients(arr_inputs, arr_targets, m_arr_gradients,
+            [this, localSamples, &outputLayerOffset, &isOutputLayer](const DenseLayerShape& shape, double* layerGradients)
+            {
+                // the output layer comes first, and is small -> copied with the sample count
+                if (isOutputLayer)
+                {
+                    isOutputLayer = false;
+                    outputLayerOffset = shape.offset;
+
+                    m_arr_outputLayerJob.assign(layerGradients, layerGradients + shape.getTotalWeights());
+                    m_arr_outputLayerJob.push_back(double(localSamples));
+                    _pushJob(m_arr_outputLayerJob.data(), uint32_t(m_arr_outputLayerJob.size()));
+                }
+                else
+                {
+                    _pushJob(layerGradients, shape.getTotalWeights());
+                }
+            });
+
+        _waitJobs();
+
+        const uint64_t totalSamples = uint64_t(m_arr_outputLayerJob.back());
+        if (totalSamples == 0)
+            return false; // only zero gradients, nothing to apply
+
+        std::copy(m_arr_outputLayerJob.begin(), m_arr_outputLayerJob.end() - 1, m_arr_gradients.begin() + outputLayerOffset);
+
+        // same summed gradients everywhere -> same weights everywhere
+        m_trainer.applyGradients(m_arr_gradients, uint32_t(totalSamples));
+
+        m_totalSamples += totalSamples;
+        return true;
+    }
+
+    if (localSamples > 0)
+        m_trainer.trainBatch(arr_inputs, arr_targets);
+
+    m_localSamples += localSamples;
+
+    if (++m_totalBatches % m_syncInterval != 0)
+        return true; // only known at the synchronizations
+
+    const uint64_t totalSamples = _averageWeights();
+
+    // nobody trained since the previous synchronization -> the weights were already averaged there
+    m_totalSamples += totalSamples;
+    return totalSamples > 0;
+}
+
+uint64_t DistributedTrainer::_averageWeights(void)
+{
+    m_network.getWeights(m_arr_weights);
+
+    // one more value -> the sample count is summed with the weights
+    m_arr_weights.push_back(double(m_localSamples));
+    m_localSamples = 0;
+
+    m_allReduce.allReduce(m_arr_weights.data(), uint32_t(m_arr_weights.size()));
+
+    const uint64_t totalSamples = uint64_t(m_arr_weights.back());
+    m_arr_weights.pop_back();
+
+    const double scale = 1.0 / m_allReduce.getWorldSize();
+    for (double& weight : m_arr_weights)
+        weight *= scale;
+
+    m_network.setWeights(m_arr_weights);
+
+    return totalSamples;
+}
+
+void DistributedTrainer::_pushJob(double* data, uint32_t totalValues)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_arr_jobs.push_back({ data, totalValues });
+        ++m_totalJobsPushed;
+    }
+    m_condition.notify_all();
+}
+
+void DistributedTrainer::_waitJobs(void)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this]() { return m_totalJobsDone == m_totalJobsPushed; });
+
+    if (m_pError)
+        std::rethrow_exception(m_pError);
+}
+
+void DistributedTrainer::_runCommunication(void)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    for (;;)
+    {
+        m_condition.wait(lock, [this]() { return m_stop || !m_arr_jobs.empty(); });
+
+        if (m_arr_jobs.empty())
+            return; // stop, and nothing left to send
+
+        const Job job = m_arr_jobs.front();
+        m_arr_jobs.pop_front();
+
+        // the training thread only touch the other layers meanwhile
+        lock.unlock();
+        if (!m_pError)
+        {
+            try
+            {
+                m_allReduce.allReduce(job.data, job.totalValues);
+            }
+            catch (...)
+            {
+                m_pError = std::current_exception();
+            }
+        }
+        lock.lock();
+
+        ++m_totalJobsDone;
+        m_condition.notify_all();
+    }
+}
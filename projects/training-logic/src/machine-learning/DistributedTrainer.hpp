@@ -0,0 +1,102 @@
+
+#pragma once
+
+#include "./NeuralNetwork.hpp"
+#include "./DataParallelTrainer.hpp"
+#include "./IAllReduce.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+//
+//
+// DISTRIBUTED TRAINER
+
+// Data parallelism across processes, each one trains on its own shard of
+// the samples and they are kept in sync through an IAllReduce.
+//
+// syncInterval == 1 -> the gradients are summed across the processes at
+// every batch, same updates everywhere. The gradients of a layer are sent
+// by a communication thread as soon as the local backward pass produced
+// them, while the previous layers are still being computed.
+//
+// syncInterval > 1 -> every process applies its own gradients, and the
+// weights are averaged across the processes every syncInterval batches
+// (local SGD) -> less communication, the weights drift in between.
+//
+// The number of samples trained by each process travels with the data
+// already exchanged (the output layer gradients, or the averaged weights)
+// -> no extra round trip to learn when every process is out of samples.
+
+class DistributedTrainer
+{
+private: // internal structures
+    struct Job
+    {
+        double* data;
+        uint32_t totalValues;
+    };
+
+private: // attr
+    NeuralNetwork& m_network;
+    DataParallelTrainer m_trainer;
+    IAllReduce& m_allReduce;
+    uint32_t m_syncInterval;
+
+    uint64_t m_totalBatches = 0;
+    uint64_t m_totalSamples = 0; // across the processes, up to the last synchronization
+    uint64_t m_localSamples = 0; // of this process, since the last synchronization
+    t_vals m_arr_gradients;
+    t_vals m_arr_weights;
+    t_vals m_arr_outputLayerJob; // the output layer gradients, then the sample count
+
+private: // attr -> communication thread
+    std::deque<Job> m_arr_jobs;
+    uint64_t m_totalJobsPushed = 0;
+    uint64_t m_totalJobsDone = 0;
+    std::exception_ptr m_pError; // thrown by the all-reduce, rethrown by _waitJobs()
+    bool m_stop = false;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::thread m_communicationThread;
+
+public: // ctor/dtor
+    DistributedTrainer(
+        NeuralNetwork& network, ThreadPool& threadPool, uint32_t shardSize,
+        IAllReduce& allReduce, uint32_t syncInterval);
+    ~DistributedTrainer();
+
+    DistributedTrainer(const DistributedTrainer& other) = delete;
+    DistributedTrainer& operator=(const DistributedTrainer& other) = delete;
+
+public: // public method(s)
+    // start every process from the weights of rank 0
+    void broadcastWeights(void);
+
+    // train on the local batch, can be empty when this process has no samples left
+    // return false once every process is out of samples, all must stop there
+    // -> with syncInterval > 1, the last synchronization averaged the weights
+    bool trainBatch(const std::vector<t_vals>& arr_inputs, const std::vector<t_vals>& arr_targets);
+
+public: // getter/setter
+    inline uint32_t getSyncInterval(void) const { return m_syncInterval; }
+
+    // trained across all the processes, as of the last synchronization
+    inline uint64_t getTotalSamples(void) const { return m_totalSamples; }
+
+private: // private method(s)
+    // return the samples trained across the processes since the previous call
+    uint64_t _averageWeights(void);
+
+    void _pushJob(double* data, uint32_t totalValues);
+    void _waitJobs(void);
+    void _runCommunication(void);
+};
+
+// DISTRIBUTED TRAINER
+//
+//
@@ -0,0 +1,319 @@
+
+#include "Gemm.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+#include <bit>
+
+namespace {
+    using Gemm::k_mr;
+    using Gemm::k_nr;
+
+    const GemmBlocking k_deterministicBlocking;
+
+    GemmBlocking s_defaultBlocking;
+    bool s_isDeterministic = false;
+    std::unordered_map<uint32_t, GemmBlocking> s_blockingsMap;
+
+    uint32_t getShapeKey(bool transA, bool transB, uint32_t m, uint32_t n, uint32_t k)
+    {
+        // log2 of each size, rounded up to the next power of 2
+        const auto getBucket = [](uint32_t size) -> uint32_t {
+            return uint32_t(std::bit_width(std::max(size, 1u) - 1));
+        };
+
+        // the transposed operands are packed with other strides -> tuned apart
+        return (uint32_t(transA) << 25) | (uint32_t(transB) << 24) |
+               (getBucket(m) << 16) | (getBucket(n) << 8) | getBucket(k);
+    }
+
+    // the packed panels are reused from call to call, one set per thread
+    thread_local std::vector<double> t_packedA;
+    thread_local std::vector<double> t_packedB;
+
+    // pack op(A)[mc][kc] as slivers of k_mr rows -> [mc / k_mr][kc][k_mr]
+    void packA(
+        bool transA, const double* A, uint32_t lda,
+        uint32_t mc, uint32_t kc, double* packed)
+    {
+        for (uint32_t ir = 0; ir < mc; ir += k_mr)
+        {
+            const uint32_t mr = std::min(k_mr, mc - ir);
+
+            for (uint32_t pp = 0; pp < kc; ++pp)
+            {
+                for (uint32_t ii = 0; ii < mr; ++ii)
+                {
+                    const uint32_t row = ir + ii;
+                    packed[ii] = transA ? A[pp * lda + row] : A[row * lda + pp];
+                }
+                for (uint32_t ii = mr; ii < k_mr; ++ii)
+                {
+                    packed[ii] = 0.0; // pad the edge sliver
+                }
+                packed += k_mr;
+            }
+        }
+    }
+
+    // pack op(B)[kc][nc] as slivers of k_nr columns -> [nc / k_nr][kc][k_nr]
+    void packB(
+        bool transB, const double* B, uint32_t ldb,
+        uint32_t kc, uint32_t nc, double* packed)
+    {
+        for (uint32_t jr = 0; jr < nc; jr += k_nr)
+        {
+            const uint32_t nr = std::min(k_nr, nc - jr);
+
+            for (uint32_t pp = 0; pp < kc; ++pp)
+            {
+                for (uint32_t jj = 0; jj < nr; ++jj)
+                {
+                    const uint32_t col = jr + jj;
+                    packed[jj] = transB ? B[col * ldb + pp] : B[pp * ldb + col];
+                }
+                for (uint32_t jj = nr; jj < k_nr; ++jj)
+                {
+                    packed[jj] = 0.0; // pad the edge sliver
+                }
+                packed += k_nr;
+            }
+        }
+    }
+
+    // C[mr][nr] = beta * C + a[k_mr][kc] * b[kc][k_nr]
+    // -> the k_mr x k_nr accumulators are meant to stay in registers
+    inline void microKernel(
+        uint32_t kc, const double* a, const double* b,
+        double beta, double* C, uint32_t ldc,
+        uint32_t mr, uint32_t nr)
+    {
+        double acc[k_mr][k_nr] = {};
+
+        for (uint32_t pp = 0; pp < kc; ++pp)
+        {
+            for (uint32_t ii = 0; ii < k_mr; ++ii)
+            {
+                for (uint32_t jj = 0; jj < k_nr; ++jj)
+                {
+                    acc[ii][jj] += a[ii] * b[jj];
+                }
+            }
+            a += k_mr;
+            b += k_nr;
+        }
+
+        for (uint32_t ii = 0; ii < mr; ++ii)
+        {
+            double* row = C + ii * ldc;
+
+            if (beta == 0.0)
+            {
+                for (uint32_t jj = 0; jj < nr; ++jj)
+                    row[jj] = acc[ii][jj];
+            }
+            else
+            {
+                for (uint32_t jj = 0; jj < nr; ++jj)
+                    row[jj] = beta * row[jj] + acc[ii][jj];
+            }
+        }
+    }
+}
+
+namespace Gemm
+{
+    void gemm(
+        bool transA, bool transB,
+        uint32_t m, uint32_t n, uint32_t k,
+        const double* A, uint32_t lda,
+        const double* B, uint32_t ldb,
+        double beta, double* C, uint32_t ldc,
+        const GemmBlocking& blocking)
+    {
+        if (m == 0 || n == 0)
+            return;
+
+        if (k == 0)
+        {
+            // nothing to multiply, only scale C
+            for (uint32_t ii = 0; ii < m; ++ii)
+                for (uint32_t jj = 0; jj < n; ++jj)
+                    C[ii * ldc + jj] = (beta == 0.0) ? 0.0 : beta * C[ii * ldc + jj];
+            return;
+        }
+
+        // keep the blocks a multiple of the register tile
+        const uint32_t blockM = std::max(k_mr, blocking.mc / k_mr * k_mr);
+        const uint32_t blockN = std::max(k_nr, blocking.nc / k_nr * k_nr);
+        const uint32_t blockK = std::max(1u, blocking.kc);
+
+        const uint32_t maxMc = std::min(blockM, (m + k_mr - 1) / k_mr * k_mr);
+        const uint32_t maxNc = std::min(blockN, (n + k_nr - 1) / k_nr * k_nr);
+        const uint32_t maxKc = std::min(blockK, k);
+
+        if (t_packedA.size() < maxMc * maxKc)
+            t_packedA.resize(maxMc * maxKc);
+        if (t_packedB.size() < maxKc * maxNc)
+            t_packedB.resize(maxKc * maxNc);
+
+        double* packedA = t_packedA.data();
+        double* packedB = t_packedB.data();
+
+        for (uint32_t jc = 0; jc < n; jc += blockN)
+        {
+            const uint32_t nc = std::min(blockN, n - jc);
+
+            for (uint32_t pc = 0; pc < k; pc += blockK)
+            {
+                const uint32_t kc = std::min(blockK, k - pc);
+
+                // only the first slice of k apply beta, the others accumulate
+                const double currBeta = (pc == 0) ? beta : 1.0;
+
+                const double* subB = transB ? (B + jc * ldb + pc) : (B + pc * ldb + jc);
+                packB(transB, subB, ldb, kc, nc, packedB);
+
+                for (uint32_t ic = 0; ic < m; ic += blockM)
+                {
+                    const uint32_t mc = std::min(blockM, m - ic);
+
+                    const double* subA = transA ? (A + pc * lda + ic) : (A + ic * lda + pc);
+                    packA(transA, subA, lda, mc, kc, packedA);
+
+                    for (uint32_t jr = 0; jr < nc; jr += k_nr)
+                    {
+                        const uint32_t nr = std::min(k_nr, nc - jr);
+                        const double* slivB = packedB + jr * kc;
+
+                        for (uint32_t ir = 0; ir < mc; ir += k_mr)
+                        {
+                            const uint32_t mr = std::min(k_mr, mc - ir);
+                            const double* slivA = packedA + ir * kc;
+
+                            microKernel(
+                                kc, slivA, slivB,
+                                currBeta, C + (ic + ir) * ldc + (jc + jr), ldc,
+                                mr, nr);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    void gemm(
+        bool transA, bool transB,
+        uint32_t m, uint32_t n, uint32_t k,
+        const double* A, uint32_t lda,
+        const double* B, uint32_t ldb,
+        double beta, double* C, uint32_t ldc)
+    {
+        gemm(transA, transB, m, n, k, A, lda, B, ldb, beta, C, ldc, getBlocking(transA, transB, m, n, k));
+    }
+
+    void gemv(
+        bool transA,
+        uint32_t m, uint32_t n,
+        const double* A, uint32_t lda,
+        const double* x,
+        double beta, double* y)
+    {
+        if (!transA)
+        {
+            // one dot product per row, 4 rows at a time -> x is loaded once per 4 rows
+            uint32_t ii = 0;
+            for (; ii + 4 <= m; ii += 4)
+            {
+                const double* row0 = A + (ii + 0) * lda;
+                const double* row1 = A + (ii + 1) * lda;
+                const double* row2 = A + (ii + 2) * lda;
+                const double* row3 = A + (ii + 3) * lda;
+
+                double sum0 = 0.0, sum1 = 0.0, sum2 = 0.0, sum3 = 0.0;
+                for (uint32_t jj = 0; jj < n; ++jj)
+                {
+                    sum0 += row0[jj] * x[jj];
+                    sum1 += row1[jj] * x[jj];
+                    sum2 += row2[jj] * x[jj];
+                    sum3 += row3[jj] * x[jj];
+                }
+
+                y[ii + 0] = (beta == 0.0 ? 0.0 : beta * y[ii + 0]) + sum0;
+                y[ii + 1] = (beta == 0.0 ? 0.0 : beta * y[ii + 1]) + sum1;
+                y[ii + 2] = (beta == 0.0 ? 0.0 : beta * y[ii + 2]) + sum2;
+                y[ii + 3] = (beta == 0.0 ? 0.0 : beta * y[ii + 3]) + sum3;
+            }
+            for (; ii < m; ++ii)
+            {
+                const double* row = A + ii * lda;
+
+                double sum = 0.0;
+                for (uint32_t jj = 0; jj < n; ++jj)
+                    sum += row[jj] * x[jj];
+
+                y[ii] = (beta == 0.0 ? 0.0 : beta * y[ii]) + sum;
+            }
+            return;
+        }
+
+        // transposed -> A is [n][m], accumulate one row of A per element of x
+        for (uint32_t ii = 0; ii < m; ++ii)
+            y[ii] = (beta == 0.0) ? 0.0 : beta * y[ii];
+
+        for (uint32_t jj = 0; jj < n; ++jj)
+        {
+            const double* row = A + jj * lda;
+            const double value = x[jj];
+
+            for (uint32_t ii = 0; ii < m; ++ii)
+                y[ii] += row[ii] * value;
+        }
+    }
+
+    const GemmBlocking& getBlocking(bool transA, bool transB, uint32_t m, uint32_t n, uint32_t k)
+    {
+        if (s_isDeterministic)
+            return k_deterministicBlocking;
+
+        if (s_blockingsMap.empty())
+            return s_defaultBlocking;
+
+        const auto it = s_blockingsMap.find(getShapeKey(transA, transB, m, n, k));
+        if (it == s_blockingsMap.end())
+            return s_defaultBlocking;
+
+        return it->second;
+    }
+
+    bool hasBlocking(bool transA, bool transB, uint32_t m, uint32_t n, uint32_t k)
+    {
+        return s_blockingsMap.count(getShapeKey(transA, transB, m, n, k)) > 0;
+    }
+
+    void setBlocking(bool transA, bool transB, uint32_t m, uint32_t n, uint32_t k, const GemmBlocking& blocking)
+    {
+        s_blockingsMap[getShapeKey(transA, transB, m, n, k)] = blocking;
+    }
+
+    void setDefaultBlocking(const GemmBlocking& blocking)
+    {
+        s_defaultBlocking = blocking;
+    }
+
+    void clearBlockings()
+    {
+        s_blockingsMap.clear();
+    }
+
+    void setDeterministic(bool isDeterministic)
+    {
+        s_isDeterministic = isDeterministic;
+    }
+
+    bool isDeterministic()
+    {
+        return s_isDeterministic;
+    }
+}
@@ -0,0 +1,72 @@
+
+#pragma once
+
+#include <cstdint>
+
+//
+//
+// GEMM
+
+// Cache blocking of the packed panels:
+// -> mc x kc block of A, meant to stay in L2
+// -> kc x nc panel of B, meant to stay in L3 (a kc x NR sliver in L1)
+struct GemmBlocking
+{
+    uint32_t mc = 128;
+    uint32_t kc = 256;
+    uint32_t nc = 1024;
+};
+
+// Row-major matrices, "lda", "ldb" and "ldc" are the row strides.
+// op(X) is X or its transpose, as requested by transA/transB.
+namespace Gemm
+{
+    // register tile of the micro-kernel
+    constexpr uint32_t k_mr = 4;
+    constexpr uint32_t k_nr = 4;
+
+    // C[m][n] = beta * C + op(A)[m][k] * op(B)[k][n]
+    // -> beta == 0 overwrite C without reading it
+    void gemm(
+        bool transA, bool transB,
+        uint32_t m, uint32_t n, uint32_t k,
+        const double* A, uint32_t lda,
+        const double* B, uint32_t ldb,
+        double beta, double* C, uint32_t ldc,
+        const GemmBlocking& blocking);
+
+    // same, with the blocking tuned for this shape (see below)
+    void gemm(
+        bool transA, bool transB,
+        uint32_t m, uint32_t n, uint32_t k,
+        const double* A, uint32_t lda,
+        const double* B, uint32_t ldb,
+        double beta, double* C, uint32_t ldc);
+
+    // y[m] = beta * y + op(A)[m][n] * x[n]
+    void gemv(
+        bool transA,
+        uint32_t m, uint32_t n,
+        const double* A, uint32_t lda,
+        const double* x,
+        double beta, double* y);
+
+    //
+    // tuned blocking, per transposition and shape bucket (each size rounded up to a power of 2)
+    // -> only update it before starting the threads that call gemm()
+
+    const GemmBlocking& getBlocking(bool transA, bool transB, uint32_t m, uint32_t n, uint32_t k);
+    bool hasBlocking(bool transA, bool transB, uint32_t m, uint32_t n, uint32_t k);
+    void setBlocking(bool transA, bool transB, uint32_t m, uint32_t n, uint32_t k, const GemmBlocking& blocking);
+    void setDefaultBlocking(const GemmBlocking& blocking);
+    void clearBlockings();
+
+    // the kc blocking decides in which order the products are summed,
+    // the deterministic mode ignore the tuned blockings -> same results on any run
+    void setDeterministic(bool isDeterministic);
+    bool isDeterministic();
+}
+
+// GEMM
+//
+//
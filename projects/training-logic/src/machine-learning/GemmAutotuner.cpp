@@ -0,0 +1,224 @@
+
+#include "GemmAutotuner.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+namespace {
+    const uint32_t k_candidatesMc[] = { 32, 64, 128, 256 };
+    const uint32_t k_candidatesKc[] = { 64, 128, 256, 512 };
+    const uint32_t k_candidatesNc[] = { 256, 1024, 4096 };
+
+    const double k_minBenchmarkSeconds = 0.002; // per candidate
+
+    struct CacheEntry
+    {
+        GemmShape shape;
+        GemmBlocking blocking;
+    };
+}
+
+GemmAutotuner::GemmAutotuner(const std::string& cacheFilename)
+    : m_cacheFilename(cacheFilename)
+{}
+
+void GemmAutotuner::tune(const std::vector<GemmShape>& arr_shapes)
+{
+    const std::string cpuName = _getCpuName();
+
+    std::vector<CacheEntry> arr_entries;
+
+    //
+    // load
+
+    std::ifstream inputFile(m_cacheFilename.c_str());
+    if (inputFile.is_open())
+    {
+        std::string line;
+        std::getline(inputFile, line);
+
+        // written on another CPU -> not relevant here
+        if (line == "cpu: " + cpuName)
+        {
+            while (std::getline(inputFile, line))
+            {
+                std::stringstream sstr(line);
+
+                CacheEntry entry;
+
+                // "transA transB m n k mc kc nc" -> anything else is retuned
+                if (sstr >> entry.shape.transA >> entry.shape.transB
+                         >> entry.shape.m >> entry.shape.n >> entry.shape.k
+                         >> entry.blocking.mc >> entry.blocking.kc >> entry.blocking.nc)
+                {
+                    arr_entries.push_back(entry);
+                    Gemm::setBlocking(
+                        entry.shape.transA, entry.shape.transB,
+                        entry.shape.m, entry.shape.n, entry.shape.k, entry.blocking);
+                }
+            }
+        }
+    }
+    inputFile.close();
+
+    //
+    // benchmark what is missing
+
+    bool hasChanged = false;
+
+    for (const GemmShape& shape : arr_shapes)
+    {
+        if (Gemm::hasBlocking(shape.transA, shape.transB, shape.m, shape.n, shape.k))
+            continue;
+
+        CacheEntry entry;
+        entry.shape = shape;
+        entry.blocking = _benchmark(shape);
+
+        arr_entries.push_back(entry);
+        Gemm::setBlocking(shape.transA, shape.transB, shape.m, shape.n, shape.k, entry.blocking);
+
+        hasChanged = true;
+    }
+
+    if (!hasChanged)
+        return;
+
+    //
+    // save -> write a temporary file then rename it, never leave half a cache
+
+    const std::string tmpFilename = m_cacheFilename + ".tmp";
+
+    std::ofstream outputFile(tmpFilename.c_str());
+    if (!outputFile.is_open())
+    {
+        std::cerr << "gemm autotuner: cannot write " << tmpFilename << std::endl;
+        return;
+    }
+
+    outputFile << "cpu: " << cpuName << "\n";
+    for (const CacheEntry& entry : arr_entries)
+    {
+        outputFile
+            << entry.shape.transA << " " << entry.shape.transB << " "
+            << entry.shape.m << " " << entry.shape.n << " " << entry.shape.k << " "
+            << entry.blocking.mc << " " << entry.blocking.kc << " " << entry.blocking.nc << "\n";
+    }
+    outputFile.close();
+
+    if (std::rename(tmpFilename.c_str(), m_cacheFilename.c_str()) != 0)
+    {
+        std::cerr << "gemm autotuner: cannot write " << m_cacheFilename << std::endl;
+    }
+}
+
+void GemmAutotuner::getLayerShapes(
+    const std::vector<uint32_t>& arr_topology, uint32_t batchSize,
+    std::vector<GemmShape>& arr_shapes)
+{
+    arr_shapes.clear();
+
+    for (uint32_t ii = 1; ii < arr_topology.size(); ++ii)
+    {
+        const uint32_t numInputs = arr_topology[ii - 1];
+        const uint32_t numOutputs = arr_topology[ii];
+
+        // see DenseLayerKernels
+        arr_shapes.push_back({ false, true, batchSize, numOutputs, numInputs }); // feedForward
+        arr_shapes.push_back({ true, false, numOutputs, numInputs, batchSize }); // weight gradients
+        if (ii > 1)
+            arr_shapes.push_back({ false, false, batchSize, numInputs, numOutputs }); // hidden gradients
+    }
+}
+
+std::string GemmAutotuner::_getCpuName()
+{
+    std::ifstream cpuInfo("/proc/cpuinfo");
+
+    std::string line;
+    while (std::getline(cpuInfo, line))
+    {
+        if (line.rfind("model name", 0) != 0)
+            continue;
+
+        const std::size_t index = line.find(':');
+        if (index != std::string::npos && index + 2 <= line.size())
+            return line.substr(index + 2);
+    }
+
+    return "unknown";
+}
+
+GemmBlocking GemmAutotuner::_benchmark(const GemmShape& shape)
+{
+    const uint32_t m = std::max(shape.m, 1u);
+    const uint32_t n = std::max(shape.n, 1u);
+    const uint32_t k = std::max(shape.k, 1u);
+
+    const uint32_t lda = shape.transA ? m : k;
+    const uint32_t ldb = shape.transB ? k : n;
+
+    std::vector<double> A(m * k);
+    std::vector<double> B(k * n);
+    std::vector<double> C(m * n, 0.0);
+
+    for (std::size_t ii = 0; ii < A.size(); ++ii)
+        A[ii] = double(ii % 7) * 0.25 - 0.75;
+    for (std::size_t ii = 0; ii < B.size(); ++ii)
+        B[ii] = double(ii % 5) * 0.25 - 0.5;
+
+    GemmBlocking bestBlocking;
+    double bestSeconds = std::numeric_limits<double>::max();
+
+    std::vector<GemmBlocking> arr_tested;
+
+    for (uint32_t mc : k_candidatesMc)
+    for (uint32_t kc : k_candidatesKc)
+    for (uint32_t nc : k_candidatesNc)
+    {
+        // blocks larger than the matrices all behave the same, only try one
+        GemmBlocking blocking;
+        blocking.mc = std::min(mc, (m + Gemm::k_mr - 1) / Gemm::k_mr * Gemm::k_mr);
+        blocking.kc = std::min(kc, k);
+        blocking.nc = std::min(nc, (n + Gemm::k_nr - 1) / Gemm::k_nr * Gemm::k_nr);
+
+        const bool alreadyTested = std::any_of(arr_tested.begin(), arr_tested.end(),
+            [&blocking](const GemmBlocking& other) {
+                return other.mc == blocking.mc && other.kc == blocking.kc && other.nc == blocking.nc;
+            });
+        if (alreadyTested)
+            continue;
+        arr_tested.push_back(blocking);
+
+        // warm up (caches, packed buffers)
+        Gemm::gemm(shape.transA, shape.transB, m, n, k, A.data(), lda, B.data(), ldb, 0.0, C.data(), n, blocking);
+
+        uint32_t totalRuns = 0;
+        const auto startTime = std::chrono::steady_clock::now();
+        double elapsedSeconds = 0.0;
+
+        do
+        {
+            Gemm::gemm(shape.transA, shape.transB, m, n, k, A.data(), lda, B.data(), ldb, 0.0, C.data(), n, blocking);
+            ++totalRuns;
+
+            const auto currTime = std::chrono::steady_clock::now();
+            elapsedSeconds = std::chrono::duration<double>(currTime - startTime).count();
+        }
+        while (elapsedSeconds < k_minBenchmarkSeconds);
+
+        const double secondsPerRun = elapsedSeconds / totalRuns;
+        if (secondsPerRun < bestSeconds)
+        {
+            bestSeconds = secondsPerRun;
+            bestBlocking = blocking;
+        }
+    }
+
+    return bestBlocking;
+}
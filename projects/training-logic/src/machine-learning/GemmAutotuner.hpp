@@ -0,0 +1,51 @@
+
+#pragma once
+
+#include "./Gemm.hpp"
+
+#include <string>
+#include <vector>
+
+//
+//
+// GEMM AUTOTUNER
+
+// Benchmark the candidate blockings on this CPU for the shapes used by the
+// layer kernels, and keep the fastest in a local cache file, so only the
+// first run pays for it. The cache is ignored if written on another CPU.
+
+struct GemmShape
+{
+    bool transA;
+    bool transB;
+    uint32_t m;
+    uint32_t n;
+    uint32_t k;
+};
+
+class GemmAutotuner
+{
+private: // attr
+    std::string m_cacheFilename;
+
+public: // ctor/dtor
+    GemmAutotuner(const std::string& cacheFilename);
+
+public: // public method(s)
+    // load the cache, benchmark the shapes missing from it then save it back
+    // -> call it before starting the training threads, see Gemm::setBlocking
+    void tune(const std::vector<GemmShape>& arr_shapes);
+
+    // the shapes of DenseLayerKernels for this topology and batch size
+    static void getLayerShapes(
+        const std::vector<uint32_t>& arr_topology, uint32_t batchSize,
+        std::vector<GemmShape>& arr_shapes);
+
+private: // private method(s)
+    static std::string _getCpuName();
+    static GemmBlocking _benchmark(const GemmShape& shape);
+};
+
+// GEMM AUTOTUNER
+//
+//
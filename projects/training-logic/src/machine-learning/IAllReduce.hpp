@@ -0,0 +1,31 @@
+
+#pragma once
+
+#include <cstdint>
+
+//
+//
+// ALL-REDUCE
+
+// Collective sum across the processes of a distributed training.
+//
+// Every process must call allReduce() the same number of times, in the
+// same order and with the same sizes -> the calls are matched by order.
+
+class IAllReduce
+{
+public: // ctor/dtor
+    virtual ~IAllReduce() = default;
+
+public: // public method(s)
+    // in place: data becomes the element-wise sum of the data of every process
+    virtual void allReduce(double* data, uint32_t totalValues) = 0;
+
+public: // getter/setter
+    virtual uint32_t getRank(void) const = 0;
+    virtual uint32_t getWorldSize(void) const = 0;
+};
+
+// ALL-REDUCE
+//
+//
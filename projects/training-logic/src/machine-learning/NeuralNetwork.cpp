@@ -5,16 +5,36 @@
 
 
 double NeuralNetwork::k_recentAvgSmoothingFactor = 100.0; // Number of training samples to average over
+uint32_t NeuralNetwork::k_minParallelWork = 16 * 1024; // the barrier cost more than smaller layers
+
+template <typename t_Task>
+void NeuralNetwork::_forEachNeuron(uint32_t totalNeurons, uint32_t connectionsPerNeuron, const t_Task& task)
+{
+    if (
+        m_pThreadPool == nullptr ||
+        m_pThreadPool->getTotalThreads() == 1 ||
+        uint64_t(totalNeurons) * connectionsPerNeuron < k_minParallelWork
+    ) {
+        task(0, totalNeurons);
+        return;
+    }
+
+    // parallelFor return once every chunk is done -> one barrier per layer
+    m_pThreadPool->parallelFor(totalNeurons, task);
+}
 
 NeuralNetwork::NeuralNetwork(const std::vector<uint32_t>& arr_topology)
-    :   m_error(0.0),
+    :   NeuralNetwork(arr_topology, RandomNumberGenerator::getClockSeed())
+{}
+
+NeuralNetwork::NeuralNetwork(const std::vector<uint32_t>& arr_topology, uint32_t seed)
+    :   m_seed(seed),
+        m_rng(seed),
+        m_error(0.0),
         m_recentAvgError(0.0)
 {
     assert( !arr_topology.empty() ); // no empty topology
 
-    RandomNumberGenerator rng;
-    rng.ensureRandomSeed();
-
     for (uint32_t ii = 0; ii < arr_topology.size(); ++ii)
     {
         uint32_t totalNeurons = arr_topology[ii];
@@ -36,7 +56,7 @@ NeuralNetwork::NeuralNetwork(const std::vector<uint32_t>& arr_topology)
         // We have a new layer, now fill it with neurons (+ the extra bias neuron)
         for (uint32_t jj = 0; jj < totalNeurons; ++jj)
         {
-            arr_new_layer.emplace_back(numOutputs, jj, rng);
+            arr_new_layer.emplace_back(numOutputs, jj, m_rng);
         }
 
         // Force the bias node's output to 1.0
@@ -64,10 +84,13 @@ void NeuralNetwork::feedForward(const t_vals &inputVals)
         t_Layer& currLayer = m_arr_layers[ii];
 
         const uint32_t num_neuron = uint32_t(currLayer.size()) - 1; // exclude bias neuron
-        for (uint32_t jj = 0; jj < num_neuron; ++jj)
+        _forEachNeuron(num_neuron, uint32_t(prevLayer.size()), [&](uint32_t begin, uint32_t end)
         {
-            currLayer[jj].feedForward(prevLayer);
-        }
+            for (uint32_t jj = begin; jj < end; ++jj)
+            {
+                currLayer[jj].feedForward(prevLayer);
+            }
+        });
     }
 }
 
@@ -90,13 +113,8 @@ void NeuralNetwork::backProp(const t_vals &arr_targetVals)
         m_error += delta * delta;
     }
     m_error /= (outputLayer.size() - 1); // get average error squared
-    m_error = std::sqrt(m_error); // RMS
 
-    // Implement a recent average measurement
-
-    m_recentAvgError =
-            (m_recentAvgError * k_recentAvgSmoothingFactor + m_error)
-            / (k_recentAvgSmoothingFactor + 1.0);
+    recordError(std::sqrt(m_error)); // RMS
 
     // error
     //
@@ -122,10 +140,13 @@ void NeuralNetwork::backProp(const t_vals &arr_targetVals)
         t_Layer &arr_currLayer = m_arr_layers[ii];
         const t_Layer &arr_nextLayer = m_arr_layers[ii + 1];
 
-        for (auto& currNeuron : arr_currLayer)
+        _forEachNeuron(uint32_t(arr_currLayer.size()), uint32_t(arr_nextLayer.size()), [&](uint32_t begin, uint32_t end)
         {
-            currNeuron.calcHiddenGradients(arr_nextLayer);
-        }
+            for (uint32_t jj = begin; jj < end; ++jj)
+            {
+                arr_currLayer[jj].calcHiddenGradients(arr_nextLayer);
+            }
+        });
     }
 
     // Gradients
@@ -145,10 +166,14 @@ void NeuralNetwork::backProp(const t_vals &arr_targetVals)
         // exclude last neuron (bias neuron)
         const uint32_t sizeLayer = uint32_t(arr_currLayer.size()) - 1;
 
-        for (uint32_t jj = 0; jj < sizeLayer; ++jj)
+        // each neuron only update its own synapse in the previous layer's neurons
+        _forEachNeuron(sizeLayer, uint32_t(arr_prevLayer.size()), [&](uint32_t begin, uint32_t end)
         {
-            arr_currLayer[jj].updateInputWeights(arr_prevLayer);
-        }
+            for (uint32_t jj = begin; jj < end; ++jj)
+            {
+                arr_currLayer[jj].updateInputWeights(arr_prevLayer);
+            }
+        });
     }
 }
 
@@ -168,3 +193,129 @@ void NeuralNetwork::getResults(t_vals &arr_resultVals) const
         arr_resultVals.push_back(outputLayer[ii].getOutputVal());
     }
 }
+
+void NeuralNetwork::getTopology(std::vector<uint32_t> &arr_topology) const
+{
+    arr_topology.clear();
+    arr_topology.reserve(m_arr_layers.size()); // pre-allocate
+
+    for (const t_Layer& layer : m_arr_layers)
+    {
+        arr_topology.push_back(uint32_t(layer.size()) - 1); // exclude bias neuron
+    }
+}
+
+uint32_t NeuralNetwork::getTotalWeights(void) const
+{
+    uint32_t total = 0;
+
+    for (uint32_t ii = 1; ii < m_arr_layers.size(); ++ii)
+    {
+        // exclude bias neuron of the current layer, it has no input
+        total += uint32_t(m_arr_layers[ii - 1].size()) * (uint32_t(m_arr_layers[ii].size()) - 1);
+    }
+
+    return total;
+}
+
+void NeuralNetwork::getWeights(t_vals &arr_weights) const
+{
+    arr_weights.clear();
+    arr_weights.reserve(getTotalWeights()); // pre-allocate
+
+    for (uint32_t ii = 1; ii < m_arr_layers.size(); ++ii)
+    {
+        const t_Layer& prevLayer = m_arr_layers[ii - 1];
+
+        const uint32_t num_neuron = uint32_t(m_arr_layers[ii].size()) - 1; // exclude bias neuron
+        for (uint32_t jj = 0; jj < num_neuron; ++jj)
+        {
+            // the bias neuron is the last one of the previous layer
+            for (const Neuron& prevNeuron : prevLayer)
+            {
+                arr_weights.push_back(prevNeuron.getOutputSynapses()[jj].weight);
+            }
+        }
+    }
+}
+
+void NeuralNetwork::setWeights(const t_vals &arr_weights)
+{
+    assert( arr_weights.size() == getTotalWeights() );
+
+    uint32_t index = 0;
+
+    for (uint32_t ii = 1; ii < m_arr_layers.size(); ++ii)
+    {
+        t_Layer& prevLayer = m_arr_layers[ii - 1];
+
+        const uint32_t num_neuron = uint32_t(m_arr_layers[ii].size()) - 1; // exclude bias neuron
+        for (uint32_t jj = 0; jj < num_neuron; ++jj)
+        {
+            for (Neuron& prevNeuron : prevLayer)
+            {
+                prevNeuron.getOutputSynapses()[jj].weight = arr_weights[index];
+                ++index;
+            }
+        }
+    }
+}
+
+void NeuralNetwork::getDeltaWeights(t_vals &arr_deltaWeights) const
+{
+    arr_deltaWeights.clear();
+    arr_deltaWeights.reserve(getTotalWeights()); // pre-allocate
+
+    for (uint32_t ii = 1; ii < m_arr_layers.size(); ++ii)
+    {
+        const t_Layer& prevLayer = m_arr_layers[ii - 1];
+
+        const uint32_t num_neuron = uint32_t(m_arr_layers[ii].size()) - 1; // exclude bias neuron
+        for (uint32_t jj = 0; jj < num_neuron; ++jj)
+        {
+            for (const Neuron& prevNeuron : prevLayer)
+            {
+                arr_deltaWeights.push_back(prevNeuron.getOutputSynapses()[jj].deltaWeight);
+            }
+        }
+    }
+}
+
+void NeuralNetwork::setDeltaWeights(const t_vals &arr_deltaWeights)
+{
+    assert( arr_deltaWeights.size() == getTotalWeights() );
+
+    uint32_t index = 0;
+
+    for (uint32_t ii = 1; ii < m_arr_layers.size(); ++ii)
+    {
+        t_Layer& prevLayer = m_arr_layers[ii - 1];
+
+        const uint32_t num_neuron = uint32_t(m_arr_layers[ii].size()) - 1; // exclude bias neuron
+        for (uint32_t jj = 0; jj < num_neuron; ++jj)
+        {
+            for (Neuron& prevNeuron : prevLayer)
+            {
+                prevNeuron.getOutputSynapses()[jj].deltaWeight = arr_deltaWeights[index];
+                ++index;
+            }
+        }
+    }
+}
+
+void NeuralNetwork::recordError(double error)
+{
+    m_error = error;
+
+    // Implement a recent average measurement
+
+    m_recentAvgError =
+            (m_recentAvgError * k_recentAvgSmoothingFactor + m_error)
+            / (k_recentAvgSmoothingFactor + 1.0);
+}
+
+void NeuralNetwork::setErrors(double error, double recentAvgError)
+{
+    m_error = error;
+    m_recentAvgError = recentAvgError;
+}
@@ -5,6 +5,7 @@
 
 
 #include "../utilities/RandomNumberGenerator.hpp"
+#include "../utilities/ThreadPool.hpp"
 
 //
 //
@@ -16,6 +17,8 @@ class NeuralNetwork
 {
 private: // attr
     std::vector<t_Layer> m_arr_layers; // m_layers[layerNum][neuronNum]
+    uint32_t m_seed; // of the initial weights
+    RandomNumberGenerator m_rng; // seeded with m_seed, saved in the checkpoints
 
 private: // attr -> error
     double m_error;
@@ -23,17 +26,58 @@ private: // attr -> error
 private: // static attr -> error
     static double k_recentAvgSmoothingFactor;
 
+private: // attr -> intra-layer parallelism
+    ThreadPool* m_pThreadPool = nullptr; // not owned, nullptr -> single threaded
+private: // static attr -> intra-layer parallelism
+    static uint32_t k_minParallelWork; // under this many connections a layer stays single threaded
+
 public: // ctor/dtor
-    NeuralNetwork(const std::vector<uint32_t> &arr_topology);
+    NeuralNetwork(const std::vector<uint32_t> &arr_topology); // seeded from the clock
+    NeuralNetwork(const std::vector<uint32_t> &arr_topology, uint32_t seed); // reproducible
 
 public: // public method(s)
     void feedForward(const t_vals &inputVals);
     void backProp(const t_vals &targetVals);
     void getResults(t_vals &resultVals) const;
 
+public: // public method(s) -> weights
+    // flat layout, one row-major matrix per pair of layers:
+    // [numOutputs][numInputs + 1] -> the bias weight is last in each row
+    void getTopology(std::vector<uint32_t> &arr_topology) const;
+    uint32_t getTotalWeights(void) const;
+    void getWeights(t_vals &arr_weights) const;
+    void setWeights(const t_vals &arr_weights); // the delta weights are left untouched
+
+    // optimizer state (last update of each weight), same layout as the weights
+    void getDeltaWeights(t_vals &arr_deltaWeights) const;
+    void setDeltaWeights(const t_vals &arr_deltaWeights);
+
+public: // public method(s) -> intra-layer parallelism
+    // split the per-neuron loops of the wide layers across the pool
+    inline void setThreadPool(ThreadPool* pThreadPool) { m_pThreadPool = pThreadPool; }
+
+    // the break-even depends on the machine, see bin/benchmark --latency-samples
+    static inline void setMinParallelWork(uint32_t minParallelWork) { k_minParallelWork = minParallelWork; }
+    static inline uint32_t getMinParallelWork(void) { return k_minParallelWork; }
+
 public: // public method(s) -> error
+    // update the error for a sample trained outside of backProp (batched trainers)
+    void recordError(double error);
+
     inline double getError(void) const { return m_error; }
     inline double getRecentAverageError(void) const { return m_recentAvgError; }
+
+    // resume from a checkpoint
+    void setErrors(double error, double recentAvgError);
+
+public: // getter/setter
+    inline uint32_t getSeed(void) const { return m_seed; }
+    inline RandomNumberGenerator& getRandomNumberGenerator(void) { return m_rng; }
+    inline const RandomNumberGenerator& getRandomNumberGenerator(void) const { return m_rng; }
+
+private: // private method(s)
+    template <typename t_Task>
+    void _forEachNeuron(uint32_t totalNeurons, uint32_t connectionsPerNeuron, const t_Task& task);
 };
 
 // NET
@@ -1,76 +1,23 @@
 
 #include "Neuron.hpp"
 
+#include "ActivationFunctions.hpp"
 
 #include <cassert>
 
 
 
 
-namespace ActivationFunctions {
-    namespace tanh {
-        double activation(double x)
-        {
-            // tanh - output range [-1.0..1.0]
-            return std::tanh(x);
-        }
-
-        double derivative(double x)
-        {
-            // tanh derivative
-
-            // faster, less accurate
-            // return 1.0 - x * x;
-
-            return 1.0 - std::tanh(x * x);
-        }
-    }
-
-    namespace relu {
-        double activation(double x)
-        {
-            // relu - output range [0.0..1.0]
-            return std::max(x, 0.0);
-        }
-
-        double derivative(double x)
-        {
-            // relu derivative
-            // return x < 0.0 ? 0.0 : 1.0;
-            return x < 0.0 ? 0.0 : x;
-        }
-    }
-
-    namespace leakyRelu {
-        double activation(double x)
-        {
-            // leaky relu
-            if (x > 0) {
-                return x;
-            }
-            return x * 0.1;
-        }
-
-        double derivative(double x)
-        {
-            // leaky relu derivative
-            return x < 0.1 ? 0.0 : x;
-        }
-    }
-}
-
-
-
-
-
-
-
-
 namespace {
     double k_learningRate = 0.15;  // overall net learning rate, [0.0..1.0]
     double k_alpha = 0.5; // momentum, multiplier of last deltaWeight, [0.0..1.0]
 }
 
+double Neuron::getLearningRate()
+{
+    return k_learningRate;
+}
+
 Neuron::Neuron(uint32_t numOutputs, uint32_t myIndex, RandomNumberGenerator& rng)
     : _layerIndex(myIndex)
 {
@@ -84,8 +31,6 @@ Neuron::Neuron(uint32_t numOutputs, uint32_t myIndex, RandomNumberGenerator& rng
     }
 }
 
-// #define D_USE_RELU
-
 void Neuron::feedForward(const t_Layer &prevLayer)
 {
     double sum = 0.0;
@@ -55,6 +55,12 @@ public: // getter/setter
     inline void     setOutputVal(double val) { _outputVal = val; }
     inline double   getOutputVal(void) const { return _outputVal; }
 
+    inline SynapseConnections&          getOutputSynapses(void) { return _outputSynapses; }
+    inline const SynapseConnections&    getOutputSynapses(void) const { return _outputSynapses; }
+
+public: // static method(s)
+    static double   getLearningRate();
+
 private: // private method(s)
     double  _sumDOW(const t_Layer &arr_nextLayer) const;
 
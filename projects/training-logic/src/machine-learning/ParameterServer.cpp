@@ -0,0 +1,115 @@
+
+#include "ParameterServer.hpp"
+
+#include <cassert>
+#include <stdexcept>
+
+//
+//
+// SERVER
+
+ParameterServer::ParameterServer(const std::string& address, uint32_t worldSize)
+    :   m_listener(address),
+        m_worldSize(worldSize)
+{
+    assert( worldSize > 0 );
+}
+
+uint64_t ParameterServer::run(void)
+{
+    m_arr_workers.clear();
+    m_arr_workers.resize(m_worldSize);
+
+    // the workers connect in any order, each one starts by sending its rank
+    for (uint32_t ii = 0; ii < m_worldSize; ++ii)
+    {
+        SocketChannel channel = m_listener.accept();
+
+        uint32_t rank = 0;
+        channel.receiveAll(&rank, sizeof(rank));
+
+        if (rank >= m_worldSize || m_arr_workers[rank].isOpen())
+            throw std::runtime_error("parameter server: invalid worker rank " + std::to_string(rank));
+
+        m_arr_workers[rank] = std::move(channel);
+    }
+
+    uint64_t totalServed = 0;
+
+    for (;;)
+    {
+        // message: total values (u32), then the values (f64 each)
+        uint32_t totalValues = 0;
+        if (!m_arr_workers[0].tryReceiveAll(&totalValues, sizeof(totalValues)))
+            return totalServed; // the training is over
+
+        m_arr_sum.resize(totalValues);
+        m_arr_receiveBuffer.resize(totalValues);
+
+        m_arr_workers[0].receiveAll(m_arr_sum.data(), totalValues * sizeof(double));
+
+        // in rank order -> the same sums on every run
+        for (uint32_t rank = 1; rank < m_worldSize; ++rank)
+        {
+            uint32_t workerTotalValues = 0;
+            m_arr_workers[rank].receiveAll(&workerTotalValues, sizeof(workerTotalValues));
+
+            if (workerTotalValues != totalValues)
+                throw std::runtime_error("parameter server: the workers are out of sync");
+
+            m_arr_workers[rank].receiveAll(m_arr_receiveBuffer.data(), totalValues * sizeof(double));
+
+            for (uint32_t ii = 0; ii < totalValues; ++ii)
+            {
+                m_arr_sum[ii] += m_arr_receiveBuffer[ii];
+            }
+        }
+
+        for (SocketChannel& worker : m_arr_workers)
+        {
+            worker.sendAll(m_arr_sum.data(), totalValues * sizeof(double));
+        }
+
+        ++totalServed;
+    }
+}
+
+// SERVER
+//
+//
+
+
+
+
+
+
+
+
+
+
+
+
+//
+//
+// WORKER
+
+ParameterServerAllReduce::ParameterServerAllReduce(const std::string& address, uint32_t rank, uint32_t worldSize)
+    :   m_rank(rank),
+        m_worldSize(worldSize)
+{
+    assert( rank < worldSize );
+
+    m_serverChannel = SocketChannel::connect(address);
+    m_serverChannel.sendAll(&m_rank, sizeof(m_rank));
+}
+
+void ParameterServerAllReduce::allReduce(double* data, uint32_t totalValues)
+{
+    m_serverChannel.sendAll(&totalValues, sizeof(totalValues));
+    m_serverChannel.sendAll(data, totalValues * sizeof(double));
+    m_serverChannel.receiveAll(data, totalValues * sizeof(double));
+}
+
+// WORKER
+//
+//
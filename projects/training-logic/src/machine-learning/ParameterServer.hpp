@@ -0,0 +1,64 @@
+
+#pragma once
+
+#include "./IAllReduce.hpp"
+
+#include "../utilities/SocketChannel.hpp"
+
+#include <string>
+#include <vector>
+
+//
+//
+// PARAMETER SERVER
+
+// Central process of a distributed training, the alternative to the ring:
+// each worker sends its data, the server sums them in rank order and sends
+// the sum back to every worker.
+//
+// Simpler than the ring and tolerant of uneven links, but the server
+// receives and sends worldSize times the data -> it is the bottleneck
+// as the workers are added.
+
+class ParameterServer
+{
+private: // attr
+    SocketListener m_listener;
+    uint32_t m_worldSize;
+
+    std::vector<SocketChannel> m_arr_workers; // by rank
+    std::vector<double> m_arr_sum;
+    std::vector<double> m_arr_receiveBuffer;
+
+public: // ctor/dtor
+    ParameterServer(const std::string& address, uint32_t worldSize);
+
+public: // public method(s)
+    // accept the workers, then serve their all-reduce until they disconnect,
+    // return the number of all-reduce served
+    uint64_t run(void);
+};
+
+// the worker side of ParameterServer
+class ParameterServerAllReduce : public IAllReduce
+{
+private: // attr
+    uint32_t m_rank;
+    uint32_t m_worldSize;
+
+    SocketChannel m_serverChannel;
+
+public: // ctor/dtor
+    ParameterServerAllReduce(const std::string& address, uint32_t rank, uint32_t worldSize);
+
+public: // public method(s)
+    void allReduce(double* data, uint32_t totalValues) override;
+
+public: // getter/setter
+    inline uint32_t getRank(void) const override { return m_rank; }
+    inline uint32_t getWorldSize(void) const override { return m_worldSize; }
+};
+
+// PARAMETER SERVER
+//
+//
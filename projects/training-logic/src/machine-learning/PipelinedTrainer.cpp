@@ -0,0 +1,330 @@
+
+#include "PipelinedTrainer.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+PipelinedTrainer::PipelinedTrainer(NeuralNetwork& network, uint32_t totalStages, uint32_t microBatchSize)
+    :   m_network(network),
+        m_microBatchSize(microBatchSize)
+{
+    assert( totalStages > 0 );
+    assert( microBatchSize > 0 );
+
+    std::vector<uint32_t> arr_topology;
+    m_network.getTopology(arr_topology);
+    makeDenseLayerShapes(arr_topology, m_arr_shapes);
+
+    // can't have more stages than layers to compute
+    totalStages = std::min(totalStages, uint32_t(m_arr_shapes.size()));
+
+    //
+    // split the layers in contiguous ranges of roughly the same amount of weights
+
+    const uint32_t totalWeights = m_network.getTotalWeights();
+
+    uint32_t currLayer = 0;
+    uint32_t weightsSoFar = 0;
+    for (uint32_t ii = 0; ii < totalStages; ++ii)
+    {
+        auto newStage = std::make_unique<Stage>();
+        newStage->firstLayer = currLayer;
+
+        const uint32_t remainingStages = totalStages - ii - 1;
+        const uint32_t targetWeights = uint64_t(totalWeights) * (ii + 1) / totalStages;
+
+        // at least one layer, and leave at least one layer per remaining stage
+        do
+        {
+            weightsSoFar += m_arr_shapes[currLayer].getTotalWeights();
+            ++currLayer;
+        }
+        while (
+            currLayer + remainingStages < m_arr_shapes.size() &&
+            weightsSoFar + m_arr_shapes[currLayer].getTotalWeights() / 2 <= targetWeights
+        );
+
+        if (remainingStages == 0)
+            currLayer = uint32_t(m_arr_shapes.size());
+
+        newStage->lastLayer = currLayer;
+
+        const DenseLayerShape& firstShape = m_arr_shapes[newStage->firstLayer];
+        const DenseLayerShape& lastShape = m_arr_shapes[newStage->lastLayer - 1];
+        const uint32_t stageWeights = lastShape.offset + lastShape.getTotalWeights() - firstShape.offset;
+        newStage->arr_weightGradients.assign(stageWeights, 0.0);
+
+        m_arr_stages.push_back(std::move(newStage));
+    }
+
+    // start the stages once they all exist, they talk to their neighbours
+    for (uint32_t ii = 0; ii < m_arr_stages.size(); ++ii)
+    {
+        m_arr_stages[ii]->thread = std::thread(&PipelinedTrainer::_runStage, this, ii);
+    }
+}
+
+PipelinedTrainer::~PipelinedTrainer()
+{
+    // the stop message is forwarded from stage to stage
+    Message stopMessage;
+    stopMessage.type = Message::Type::stop;
+    _pushForward(0, std::move(stopMessage));
+
+    for (auto& stage : m_arr_stages)
+    {
+        stage->thread.join();
+    }
+}
+
+void PipelinedTrainer::trainBatch(const std::vector<t_vals>& arr_inputs, const std::vector<t_vals>& arr_targets)
+{
+    assert( arr_inputs.size() == arr_targets.size() );
+
+    if (arr_inputs.empty())
+        return;
+
+    const uint32_t numInputs = m_arr_shapes.front().numInputs;
+    const uint32_t numOutputs = m_arr_shapes.back().numOutputs;
+
+    // a queue must be able to hold all the micro-batches of a batch,
+    // a full one would block a stage and its neighbour on each other
+    const uint32_t totalMicroBatches = (uint32_t(arr_inputs.size()) + m_microBatchSize - 1) / m_microBatchSize;
+    if (totalMicroBatches > getMaxMicroBatches())
+        throw std::invalid_argument("too many micro-batches in the batch");
+
+    m_totalSamples = uint32_t(arr_inputs.size());
+    m_totalMicroBatches = totalMicroBatches;
+
+    // the network might have been trained by something else in between
+    m_network.getWeights(m_arr_weights);
+    m_arr_deltaWeights.resize(m_arr_weights.size());
+
+    m_arr_errors.assign(m_totalSamples, 0.0);
+    m_arr_microTargets.resize(m_totalMicroBatches);
+    m_totalFlushedStages.store(0, std::memory_order_relaxed);
+
+    std::vector<Message> arr_messages(m_totalMicroBatches);
+
+    for (uint32_t ii = 0; ii < m_totalMicroBatches; ++ii)
+    {
+        const uint32_t firstSample = ii * m_microBatchSize;
+        const uint32_t lastSample = std::min(firstSample + m_microBatchSize, m_totalSamples);
+
+        Message& message = arr_messages[ii];
+        message.type = Message::Type::forward;
+        message.microBatchIndex = ii;
+        message.values.clear();
+        message.values.reserve((lastSample - firstSample) * numInputs); // pre-allocate
+
+        t_vals& microTargets = m_arr_microTargets[ii];
+        microTargets.clear();
+        microTargets.reserve((lastSample - firstSample) * numOutputs); // pre-allocate
+
+        for (uint32_t jj = firstSample; jj < lastSample; ++jj)
+        {
+            assert( arr_inputs[jj].size() == numInputs );
+            assert( arr_targets[jj].size() == numOutputs );
+
+            message.values.insert(message.values.end(), arr_inputs[jj].begin(), arr_inputs[jj].end());
+            microTargets.insert(microTargets.end(), arr_targets[jj].begin(), arr_targets[jj].end());
+        }
+    }
+
+    // fill the pipeline
+    for (Message& message : arr_messages)
+    {
+        _pushForward(0, std::move(message));
+    }
+
+    // wait (blocked) for every stage to apply its weight gradients
+    for (uint32_t totalFlushed = m_totalFlushedStages.load(std::memory_order_acquire);
+         totalFlushed < m_arr_stages.size();
+         totalFlushed = m_totalFlushedStages.load(std::memory_order_acquire))
+    {
+        m_totalFlushedStages.wait(totalFlushed, std::memory_order_acquire);
+    }
+
+    m_network.setWeights(m_arr_weights);
+    m_network.setDeltaWeights(m_arr_deltaWeights);
+
+    for (double error : m_arr_errors)
+    {
+        m_network.recordError(error);
+    }
+}
+
+void PipelinedTrainer::_pushForward(uint32_t stageIndex, Message&& message)
+{
+    Stage& stage = *m_arr_stages[stageIndex];
+
+    stage.forwardQueue.push(std::move(message));
+    stage.totalPushed.fetch_add(1, std::memory_order_release);
+    stage.totalPushed.notify_one();
+}
+
+void PipelinedTrainer::_pushBackward(uint32_t stageIndex, Message&& message)
+{
+    Stage& stage = *m_arr_stages[stageIndex];
+
+    stage.backwardQueue.push(std::move(message));
+    stage.totalPushed.fetch_add(1, std::memory_order_release);
+    stage.totalPushed.notify_one();
+}
+
+void PipelinedTrainer::_runStage(uint32_t stageIndex)
+{
+    Stage& stage = *m_arr_stages[stageIndex];
+
+    Message message;
+
+    for (;;)
+    {
+        // read before trying the queues -> a push made after the tries changes it, no lost wake-up
+        const uint32_t totalPushed = stage.totalPushed.load(std::memory_order_acquire);
+
+        // drain the backward messages first, they release the stored activations
+        if (stage.backwardQueue.tryPop(message))
+        {
+            _backward(stageIndex, message.microBatchIndex, message.values);
+        }
+        else if (stage.forwardQueue.tryPop(message))
+        {
+            if (message.type == Message::Type::stop)
+            {
+                if (stageIndex + 1 < m_arr_stages.size())
+                    _pushForward(stageIndex + 1, std::move(message));
+                return;
+            }
+
+            _forward(stageIndex, message);
+        }
+        else
+        {
+            // idle -> blocked until the next push, not spinning between the batches
+            stage.totalPushed.wait(totalPushed, std::memory_order_acquire);
+        }
+    }
+}
+
+void PipelinedTrainer::_forward(uint32_t stageIndex, Message& message)
+{
+    Stage& stage = *m_arr_stages[stageIndex];
+
+    const uint32_t microBatchIndex = message.microBatchIndex;
+    const uint32_t totalLayers = stage.lastLayer - stage.firstLayer;
+    const DenseLayerShape& firstShape = m_arr_shapes[stage.firstLayer];
+    const uint32_t batchSize = uint32_t(message.values.size()) / firstShape.numInputs;
+
+    if (stage.arr_activations.size() < m_totalMicroBatches)
+        stage.arr_activations.resize(m_totalMicroBatches);
+
+    std::vector<t_vals>& arr_activations = stage.arr_activations[microBatchIndex];
+    arr_activations.resize(totalLayers + 1);
+    arr_activations[0] = std::move(message.values);
+
+    for (uint32_t ii = 0; ii < totalLayers; ++ii)
+    {
+        const DenseLayerShape& shape = m_arr_shapes[stage.firstLayer + ii];
+
+        arr_activations[ii + 1].resize(batchSize * shape.numOutputs);
+
+        DenseLayerKernels::feedForward(
+            shape, m_arr_weights.data() + shape.offset,
+            arr_activations[ii].data(), batchSize, arr_activations[ii + 1].data());
+    }
+
+    const t_vals& outputs = arr_activations.back();
+
+    if (stageIndex + 1 < m_arr_stages.size())
+    {
+        // the stage keeps its own copy for the backward pass
+        Message nextMessage;
+        nextMessage.type = Message::Type::forward;
+        nextMessage.microBatchIndex = microBatchIndex;
+        nextMessage.values = outputs;
+
+        _pushForward(stageIndex + 1, std::move(nextMessage));
+        return;
+    }
+
+    //
+    // last stage -> the backward pass starts right away
+
+    const uint32_t numOutputs = m_arr_shapes.back().numOutputs;
+    const t_vals& targets = m_arr_microTargets[microBatchIndex];
+
+    for (uint32_t ii = 0; ii < batchSize; ++ii)
+    {
+        m_arr_errors[microBatchIndex * m_microBatchSize + ii] = DenseLayerKernels::calcSampleError(
+            outputs.data() + ii * numOutputs, targets.data() + ii * numOutputs, numOutputs);
+    }
+
+    t_vals gradients(outputs.size());
+    DenseLayerKernels::calcOutputGradients(outputs.data(), targets.data(), uint32_t(outputs.size()), gradients.data());
+
+    _backward(stageIndex, microBatchIndex, gradients);
+}
+
+void PipelinedTrainer::_backward(uint32_t stageIndex, uint32_t microBatchIndex, t_vals& gradients)
+{
+    Stage& stage = *m_arr_stages[stageIndex];
+
+    std::vector<t_vals>& arr_activations = stage.arr_activations[microBatchIndex];
+
+    const uint32_t stageOffset = m_arr_shapes[stage.firstLayer].offset;
+
+    t_vals inputGradients;
+
+    for (uint32_t ii = stage.lastLayer; ii > stage.firstLayer; --ii)
+    {
+        const DenseLayerShape& shape = m_arr_shapes[ii - 1];
+        const t_vals& inputs = arr_activations[ii - 1 - stage.firstLayer];
+        const uint32_t batchSize = uint32_t(gradients.size()) / shape.numOutputs;
+
+        DenseLayerKernels::accumulateWeightGradients(
+            shape, inputs.data(), gradients.data(), batchSize,
+            stage.arr_weightGradients.data() + (shape.offset - stageOffset));
+
+        // the input layer has no gradients
+        if (ii == 1)
+            break;
+
+        inputGradients.resize(batchSize * shape.numInputs);
+        DenseLayerKernels::calcHiddenGradients(
+            shape, m_arr_weights.data() + shape.offset,
+            gradients.data(), inputs.data(), batchSize, inputGradients.data());
+
+        gradients.swap(inputGradients);
+    }
+
+    arr_activations.clear();
+
+    if (stageIndex > 0)
+    {
+        Message message;
+        message.type = Message::Type::backward;
+        message.microBatchIndex = microBatchIndex;
+        message.values = std::move(gradients);
+
+        _pushBackward(stageIndex - 1, std::move(message));
+    }
+
+    if (++stage.totalBackward < m_totalMicroBatches)
+        return;
+
+    //
+    // flush -> all the micro-batches are back, apply the averaged gradients
+
+    DenseLayerKernels::applyWeightGradients(
+        stage.arr_weightGradients.data(), uint32_t(stage.arr_weightGradients.size()),
+        1.0 / m_totalSamples,
+        m_arr_weights.data() + stageOffset, m_arr_deltaWeights.data() + stageOffset);
+
+    std::fill(stage.arr_weightGradients.begin(), stage.arr_weightGradients.end(), 0.0);
+    stage.totalBackward = 0;
+
+    m_totalFlushedStages.fetch_add(1, std::memory_order_release);
+    m_totalFlushedStages.notify_all();
+}
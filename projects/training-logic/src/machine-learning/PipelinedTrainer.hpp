@@ -0,0 +1,105 @@
+
+#pragma once
+
+#include "./NeuralNetwork.hpp"
+#include "./DenseLayers.hpp"
+
+#include "../utilities/SpscQueue.hpp"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+//
+//
+// PIPELINED TRAINER
+
+// Model-parallel trainer: contiguous ranges of layers are assigned to
+// "stages", each stage runs on its own thread and the micro-batches are
+// streamed through them as a pipeline.
+//
+// The schedule is synchronous (GPipe): the weight gradients of all the
+// micro-batches of a batch are accumulated and applied once the last one
+// went back through the first stage, every micro-batch of a batch is
+// computed with the same weights.
+
+class PipelinedTrainer
+{
+private: // internal structures
+    struct Message
+    {
+        enum class Type { forward, backward, stop };
+
+        Type        type = Type::stop;
+        uint32_t    microBatchIndex = 0;
+        t_vals      values; // [microBatchSize][numValues]
+    };
+
+    // no stage can have more messages in flight than micro-batches in a batch
+    static constexpr uint32_t k_queueCapacity = 64;
+    using t_MessageQueue = SpscQueue<Message, k_queueCapacity>;
+
+    struct Stage
+    {
+        uint32_t firstLayer; // index in m_arr_shapes
+        uint32_t lastLayer; // exclusive
+
+        t_vals arr_weightGradients; // same layout as the stage's part of the weights
+
+        // per micro-batch: the stage inputs, then the outputs of each of its layers
+        std::vector<std::vector<t_vals>> arr_activations;
+
+        uint32_t totalBackward = 0; // micro-batches back for the current batch
+
+        t_MessageQueue forwardQueue; // pushed by the previous stage (or the trainer)
+        t_MessageQueue backwardQueue; // pushed by the next stage
+        std::atomic<uint32_t> totalPushed{0}; // bumped after each push -> an idle stage waits on it
+
+        std::thread thread;
+    };
+
+private: // attr
+    NeuralNetwork& m_network;
+
+    DenseLayerShapes m_arr_shapes;
+    t_vals m_arr_weights; // written back in the network after each batch
+    t_vals m_arr_deltaWeights; // same
+
+    std::vector<std::unique_ptr<Stage>> m_arr_stages;
+
+private: // attr -> current batch
+    uint32_t m_microBatchSize;
+    uint32_t m_totalMicroBatches = 0;
+    uint32_t m_totalSamples = 0;
+    std::vector<t_vals> m_arr_microTargets; // read by the last stage
+    t_vals m_arr_errors; // written by the last stage, per sample
+    std::atomic<uint32_t> m_totalFlushedStages{0};
+
+public: // ctor/dtor
+    PipelinedTrainer(NeuralNetwork& network, uint32_t totalStages, uint32_t microBatchSize);
+    ~PipelinedTrainer();
+
+    PipelinedTrainer(const PipelinedTrainer& other) = delete;
+    PipelinedTrainer& operator=(const PipelinedTrainer& other) = delete;
+
+public: // public method(s)
+    // at most getMaxMicroBatches() micro-batches, throw std::invalid_argument otherwise
+    void trainBatch(const std::vector<t_vals>& arr_inputs, const std::vector<t_vals>& arr_targets);
+
+public: // getter/setter
+    inline uint32_t getTotalStages(void) const { return uint32_t(m_arr_stages.size()); }
+
+    // per batch -> batch size up to getMaxMicroBatches() * micro-batch size
+    static constexpr uint32_t getMaxMicroBatches(void) { return k_queueCapacity - 1; }
+
+private: // private method(s)
+    void _pushForward(uint32_t stageIndex, Message&& message);
+    void _pushBackward(uint32_t stageIndex, Message&& message);
+    void _runStage(uint32_t stageIndex);
+    void _forward(uint32_t stageIndex, Message& message);
+    void _backward(uint32_t stageIndex, uint32_t microBatchIndex, t_vals& gradients);
+};
+
+// PIPELINED TRAINER
+//
+//
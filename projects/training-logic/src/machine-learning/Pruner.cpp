@@ -0,0 +1,134 @@
+
+#include "Pruner.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <utility>
+
+Pruner::Pruner(NeuralNetwork& network)
+    :   m_network(network)
+{
+    std::vector<uint32_t> arr_topology;
+    m_network.getTopology(arr_topology);
+    makeDenseLayerShapes(arr_topology, m_arr_shapes);
+
+    m_arr_mask.assign(m_network.getTotalWeights(), 1);
+}
+
+uint64_t Pruner::pruneByThreshold(double threshold)
+{
+    m_network.getWeights(m_arr_weights);
+
+    uint64_t totalPruned = 0;
+
+    for (const DenseLayerShape& shape : m_arr_shapes)
+    {
+        for (uint32_t ii = shape.offset; ii < shape.offset + shape.getTotalWeights(); ++ii)
+        {
+            if (m_arr_mask[ii] == 0 || _isBiasWeight(shape, ii) || std::abs(m_arr_weights[ii]) >= threshold)
+                continue;
+
+            m_arr_mask[ii] = 0;
+            m_arr_weights[ii] = 0.0;
+            ++totalPruned;
+        }
+    }
+
+    m_network.setWeights(m_arr_weights);
+    return totalPruned;
+}
+
+uint64_t Pruner::pruneToSparsity(double sparsity)
+{
+    assert( sparsity >= 0.0 && sparsity <= 1.0 );
+
+    m_network.getWeights(m_arr_weights);
+
+    uint64_t totalPruned = 0;
+
+    // the connection weights still alive in a layer, as (magnitude, index)
+    std::vector<std::pair<double, uint32_t>> arr_candidates;
+
+    // same sparsity in every layer -> a small layer (e.g. the inputs) is never emptied
+    for (const DenseLayerShape& shape : m_arr_shapes)
+    {
+        arr_candidates.clear();
+
+        for (uint32_t ii = shape.offset; ii < shape.offset + shape.getTotalWeights(); ++ii)
+        {
+            if (m_arr_mask[ii] != 0 && !_isBiasWeight(shape, ii))
+                arr_candidates.emplace_back(std::abs(m_arr_weights[ii]), ii);
+        }
+
+        const uint64_t totalConnections = uint64_t(shape.numOutputs) * shape.numInputs;
+        const uint64_t alreadyPruned = totalConnections - arr_candidates.size();
+        const uint64_t targetPruned = uint64_t(std::llround(sparsity * double(totalConnections)));
+
+        if (targetPruned <= alreadyPruned)
+            continue;
+
+        const uint64_t totalToPrune = targetPruned - alreadyPruned;
+
+        // the pair order break the ties by index -> same weights pruned on every run
+        std::nth_element(
+            arr_candidates.begin(),
+            arr_candidates.begin() + std::ptrdiff_t(totalToPrune - 1),
+            arr_candidates.end());
+
+        for (uint64_t ii = 0; ii < totalToPrune; ++ii)
+        {
+            const uint32_t index = arr_candidates[ii].second;
+
+            m_arr_mask[index] = 0;
+            m_arr_weights[index] = 0.0;
+        }
+
+        totalPruned += totalToPrune;
+    }
+
+    m_network.setWeights(m_arr_weights);
+    return totalPruned;
+}
+
+void Pruner::applyMask(void)
+{
+    m_network.getWeights(m_arr_weights);
+
+    for (uint32_t ii = 0; ii < m_arr_weights.size(); ++ii)
+    {
+        if (m_arr_mask[ii] == 0)
+            m_arr_weights[ii] = 0.0;
+    }
+
+    m_network.setWeights(m_arr_weights);
+}
+
+double Pruner::getSparsity(void) const
+{
+    uint64_t totalConnections = 0;
+    uint64_t totalPruned = 0;
+
+    for (const DenseLayerShape& shape : m_arr_shapes)
+    {
+        totalConnections += uint64_t(shape.numOutputs) * shape.numInputs;
+
+        for (uint32_t ii = shape.offset; ii < shape.offset + shape.getTotalWeights(); ++ii)
+        {
+            if (m_arr_mask[ii] == 0)
+                ++totalPruned;
+        }
+    }
+
+    return (totalConnections > 0) ? double(totalPruned) / double(totalConnections) : 0.0;
+}
+
+double Pruner::getScheduledSparsity(double finalSparsity, uint32_t step, uint32_t totalSteps)
+{
+    if (totalSteps == 0 || step >= totalSteps)
+        return finalSparsity;
+
+    // prune fast while there are many redundant weights, then slow down
+    const double remaining = 1.0 - double(step) / double(totalSteps);
+    return finalSparsity * (1.0 - remaining * remaining * remaining);
+}
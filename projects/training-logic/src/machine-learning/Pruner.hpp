@@ -0,0 +1,58 @@
+
+#pragma once
+
+#include "./NeuralNetwork.hpp"
+#include "./DenseLayers.hpp"
+
+//
+//
+// PRUNER
+
+// Magnitude pruning: zero the smallest weights of a network.
+//
+// The bias weights are never pruned, the sparsity is the fraction of zeroed
+// connection weights. A pruned weight is recorded in a mask, applyMask()
+// keeps it at zero while the network keeps training (iterative pruning).
+
+class Pruner
+{
+private: // attr
+    NeuralNetwork& m_network;
+
+    DenseLayerShapes m_arr_shapes;
+    std::vector<uint8_t> m_arr_mask; // per weight, 0 -> pruned, same layout as the weights
+    t_vals m_arr_weights;
+
+public: // ctor/dtor
+    Pruner(NeuralNetwork& network);
+
+public: // public method(s)
+    // prune every connection weight with |weight| < threshold, return the total pruned
+    uint64_t pruneByThreshold(double threshold);
+
+    // prune the smallest connection weights of each layer until the layer
+    // reaches the sparsity, return the total pruned (the weights pruned
+    // before are kept pruned)
+    uint64_t pruneToSparsity(double sparsity);
+
+    // zero again the pruned weights, call it after each training step
+    void applyMask(void);
+
+public: // getter/setter
+    double getSparsity(void) const;
+    inline const std::vector<uint8_t>& getMask(void) const { return m_arr_mask; }
+
+public: // static method(s)
+    // gradual pruning, cubic ramp from 0 to finalSparsity over totalSteps
+    static double getScheduledSparsity(double finalSparsity, uint32_t step, uint32_t totalSteps);
+
+private: // private method(s)
+    inline bool _isBiasWeight(const DenseLayerShape& shape, uint32_t index) const
+    {
+        return (index - shape.offset) % shape.getRowSize() == shape.numInputs;
+    }
+};
+
+// PRUNER
+//
+//
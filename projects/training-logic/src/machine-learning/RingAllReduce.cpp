@@ -0,0 +1,87 @@
+
+#include "RingAllReduce.hpp"
+
+#include <cassert>
+
+RingAllReduce::RingAllReduce(const std::string& baseAddress, uint32_t rank, uint32_t worldSize)
+    :   m_rank(rank),
+        m_worldSize(worldSize)
+{
+    assert( rank < worldSize );
+
+    if (m_worldSize == 1)
+        return; // nothing to exchange
+
+    // listen first -> the connect of the previous rank can't fail for good
+    SocketListener listener(getRankAddress(baseAddress, m_rank));
+
+    m_nextChannel = SocketChannel::connect(getRankAddress(baseAddress, (m_rank + 1) % m_worldSize));
+    m_previousChannel = listener.accept();
+}
+
+void RingAllReduce::allReduce(double* data, uint32_t totalValues)
+{
+    if (m_worldSize == 1 || totalValues == 0)
+        return;
+
+    // one chunk per rank, chunk c is [ c * total / worldSize, (c + 1) * total / worldSize )
+    const auto getChunkBegin = [this, totalValues](uint32_t chunk) -> uint32_t {
+        return uint32_t(uint64_t(chunk) * totalValues / m_worldSize);
+    };
+
+    m_arr_receiveBuffer.resize(totalValues / m_worldSize + 1);
+
+    //
+    // reduce-scatter, after it the chunk (rank + 1) is fully summed here
+
+    for (uint32_t step = 0; step + 1 < m_worldSize; ++step)
+    {
+        const uint32_t sendChunk = (m_rank + m_worldSize - step) % m_worldSize;
+        const uint32_t receiveChunk = (m_rank + m_worldSize - step - 1) % m_worldSize;
+
+        const uint32_t sendBegin = getChunkBegin(sendChunk);
+        const uint32_t sendSize = getChunkBegin(sendChunk + 1) - sendBegin;
+        const uint32_t receiveBegin = getChunkBegin(receiveChunk);
+        const uint32_t receiveSize = getChunkBegin(receiveChunk + 1) - receiveBegin;
+
+        SocketChannel::exchange(
+            m_nextChannel, data + sendBegin, sendSize * sizeof(double),
+            m_previousChannel, m_arr_receiveBuffer.data(), receiveSize * sizeof(double));
+
+        for (uint32_t ii = 0; ii < receiveSize; ++ii)
+        {
+            data[receiveBegin + ii] += m_arr_receiveBuffer[ii];
+        }
+    }
+
+    //
+    // all-gather, the summed chunks go around the ring
+
+    for (uint32_t step = 0; step + 1 < m_worldSize; ++step)
+    {
+        const uint32_t sendChunk = (m_rank + 1 + m_worldSize - step) % m_worldSize;
+        const uint32_t receiveChunk = (m_rank + m_worldSize - step) % m_worldSize;
+
+        const uint32_t sendBegin = getChunkBegin(sendChunk);
+        const uint32_t sendSize = getChunkBegin(sendChunk + 1) - sendBegin;
+        const uint32_t receiveBegin = getChunkBegin(receiveChunk);
+        const uint32_t receiveSize = getChunkBegin(receiveChunk + 1) - receiveBegin;
+
+        SocketChannel::exchange(
+            m_nextChannel, data + sendBegin, sendSize * sizeof(double),
+            m_previousChannel, data + receiveBegin, receiveSize * sizeof(double));
+    }
+}
+
+std::string RingAllReduce::getRankAddress(const std::string& baseAddress, uint32_t rank)
+{
+    if (baseAddress.rfind("tcp:", 0) == 0)
+    {
+        const std::size_t index = baseAddress.find_last_of(':');
+        const uint32_t port = uint32_t(std::stoul(baseAddress.substr(index + 1)));
+
+        return baseAddress.substr(0, index + 1) + std::to_string(port + rank);
+    }
+
+    return baseAddress + "." + std::to_string(rank);
+}
@@ -0,0 +1,53 @@
+
+#pragma once
+
+#include "./IAllReduce.hpp"
+
+#include "../utilities/SocketChannel.hpp"
+
+#include <string>
+#include <vector>
+
+//
+//
+// RING ALL-REDUCE
+
+// Peer to peer all-reduce, each process only talks to its two neighbours:
+// -> reduce-scatter: worldSize - 1 steps, each one adds a chunk received
+//    from the previous rank, then each rank owns one fully summed chunk
+// -> all-gather: worldSize - 1 steps to pass the summed chunks around
+//
+// Each process sends and receives 2 * (worldSize - 1) / worldSize of the
+// data, whatever the number of processes -> the bandwidth does not grow
+// with the world size. Each chunk is always summed in the same order.
+
+class RingAllReduce : public IAllReduce
+{
+private: // attr
+    uint32_t m_rank;
+    uint32_t m_worldSize;
+
+    SocketChannel m_nextChannel; // to rank + 1
+    SocketChannel m_previousChannel; // from rank - 1
+
+    std::vector<double> m_arr_receiveBuffer;
+
+public: // ctor/dtor
+    // rank r listens on getRankAddress(baseAddress, r), connects to rank r + 1
+    RingAllReduce(const std::string& baseAddress, uint32_t rank, uint32_t worldSize);
+
+public: // public method(s)
+    void allReduce(double* data, uint32_t totalValues) override;
+
+public: // getter/setter
+    inline uint32_t getRank(void) const override { return m_rank; }
+    inline uint32_t getWorldSize(void) const override { return m_worldSize; }
+
+public: // static method(s)
+    // "unix:/tmp/nn" -> "unix:/tmp/nn.RANK", "tcp:HOST:PORT" -> "tcp:HOST:(PORT + RANK)"
+    static std::string getRankAddress(const std::string& baseAddress, uint32_t rank);
+};
+
+// RING ALL-REDUCE
+//
+//
@@ -0,0 +1,79 @@
+
+#include "SparseLayers.hpp"
+
+#include "ActivationFunctions.hpp"
+
+std::size_t SparseLayer::getMemoryBytes(void) const
+{
+    return
+        arr_rowOffsets.size() * sizeof(uint32_t) +
+        arr_columns.size() * sizeof(uint32_t) +
+        arr_values.size() * sizeof(double) +
+        arr_biases.size() * sizeof(double);
+}
+
+void makeSparseLayer(const DenseLayerShape& shape, const double* weights, SparseLayer& layer)
+{
+    const uint32_t rowSize = shape.getRowSize();
+
+    layer.numInputs = shape.numInputs;
+    layer.numOutputs = shape.numOutputs;
+
+    layer.arr_rowOffsets.clear();
+    layer.arr_columns.clear();
+    layer.arr_values.clear();
+    layer.arr_biases.clear();
+
+    layer.arr_rowOffsets.reserve(shape.numOutputs + 1); // pre-allocate
+    layer.arr_biases.reserve(shape.numOutputs); // pre-allocate
+
+    for (uint32_t jj = 0; jj < shape.numOutputs; ++jj)
+    {
+        const double* row = weights + jj * rowSize;
+
+        layer.arr_rowOffsets.push_back(uint32_t(layer.arr_values.size()));
+
+        for (uint32_t ii = 0; ii < shape.numInputs; ++ii)
+        {
+            if (row[ii] == 0.0)
+                continue;
+
+            layer.arr_columns.push_back(ii);
+            layer.arr_values.push_back(row[ii]);
+        }
+
+        layer.arr_biases.push_back(row[shape.numInputs]);
+    }
+
+    layer.arr_rowOffsets.push_back(uint32_t(layer.arr_values.size()));
+}
+
+namespace SparseLayerKernels
+{
+    void feedForward(
+        const SparseLayer& layer,
+        const double* inputs, uint32_t batchSize, double* outputs)
+    {
+        const uint32_t* rowOffsets = layer.arr_rowOffsets.data();
+        const uint32_t* columns = layer.arr_columns.data();
+        const double* values = layer.arr_values.data();
+
+        for (uint32_t bb = 0; bb < batchSize; ++bb)
+        {
+            const double* sampleInputs = inputs + bb * layer.numInputs;
+            double* sampleOutputs = outputs + bb * layer.numOutputs;
+
+            for (uint32_t jj = 0; jj < layer.numOutputs; ++jj)
+            {
+                double sum = 0.0;
+                for (uint32_t kk = rowOffsets[jj]; kk < rowOffsets[jj + 1]; ++kk)
+                    sum += sampleInputs[columns[kk]] * values[kk];
+
+                // the bias neuron, its output is always 1.0
+                sum += layer.arr_biases[jj];
+
+                sampleOutputs[jj] = ActivationFunctions::current::activation(sum);
+            }
+        }
+    }
+}
@@ -0,0 +1,45 @@
+
+#pragma once
+
+#include "./DenseLayers.hpp"
+
+#include <vector>
+#include <cstdint>
+
+//
+//
+// SPARSE LAYERS
+
+// Weights between two layers in CSR (compressed sparse row) format:
+// -> only the non-zero connection weights are stored, row by row
+// -> the bias weights stay dense, one per output
+struct SparseLayer
+{
+    uint32_t numInputs = 0; // exclude bias neuron
+    uint32_t numOutputs = 0; // exclude bias neuron
+
+    std::vector<uint32_t> arr_rowOffsets; // [numOutputs + 1], first value of each row
+    std::vector<uint32_t> arr_columns; // input index of each value
+    t_vals arr_values;
+    t_vals arr_biases; // [numOutputs]
+
+    inline uint32_t getTotalNonZeros(void) const { return uint32_t(arr_values.size()); }
+    std::size_t getMemoryBytes(void) const;
+};
+using SparseLayers = std::vector<SparseLayer>;
+
+// compress one layer of the flat weights of NeuralNetwork::getWeights()
+void makeSparseLayer(const DenseLayerShape& shape, const double* weights, SparseLayer& layer);
+
+// Same batch layout as DenseLayerKernels: row-major [batchSize][numValues]
+namespace SparseLayerKernels
+{
+    // same sums in the same order as DenseLayerKernels/Neuron, the zeros skipped
+    void feedForward(
+        const SparseLayer& layer,
+        const double* inputs, uint32_t batchSize, double* outputs);
+}
+
+// SPARSE LAYERS
+//
+//
@@ -0,0 +1,64 @@
+
+#include "SparseNeuralNetwork.hpp"
+
+#include <cassert>
+
+SparseNeuralNetwork::SparseNeuralNetwork(const NeuralNetwork& network)
+{
+    std::vector<uint32_t> arr_topology;
+    network.getTopology(arr_topology);
+
+    DenseLayerShapes arr_shapes;
+    makeDenseLayerShapes(arr_topology, arr_shapes);
+
+    t_vals arr_weights;
+    network.getWeights(arr_weights);
+
+    m_arr_layers.resize(arr_shapes.size());
+    for (uint32_t ii = 0; ii < arr_shapes.size(); ++ii)
+    {
+        makeSparseLayer(arr_shapes[ii], arr_weights.data() + arr_shapes[ii].offset, m_arr_layers[ii]);
+    }
+
+    m_arr_activations.resize(arr_topology.size());
+    for (uint32_t ii = 0; ii < arr_topology.size(); ++ii)
+    {
+        m_arr_activations[ii].resize(arr_topology[ii]);
+    }
+}
+
+void SparseNeuralNetwork::feedForward(const t_vals &inputVals)
+{
+    assert( inputVals.size() == m_arr_activations.front().size() );
+
+    m_arr_activations.front() = inputVals;
+
+    for (uint32_t ii = 0; ii < m_arr_layers.size(); ++ii)
+    {
+        SparseLayerKernels::feedForward(
+            m_arr_layers[ii], m_arr_activations[ii].data(), 1, m_arr_activations[ii + 1].data());
+    }
+}
+
+void SparseNeuralNetwork::getResults(t_vals &resultVals) const
+{
+    resultVals = m_arr_activations.back();
+}
+
+uint64_t SparseNeuralNetwork::getTotalNonZeros(void) const
+{
+    uint64_t totalNonZeros = 0;
+    for (const SparseLayer& layer : m_arr_layers)
+        totalNonZeros += layer.getTotalNonZeros();
+
+    return totalNonZeros;
+}
+
+std::size_t SparseNeuralNetwork::getMemoryBytes(void) const
+{
+    std::size_t totalBytes = 0;
+    for (const SparseLayer& layer : m_arr_layers)
+        totalBytes += layer.getMemoryBytes();
+
+    return totalBytes;
+}
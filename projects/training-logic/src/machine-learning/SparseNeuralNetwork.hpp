@@ -0,0 +1,37 @@
+
+#pragma once
+
+#include "./NeuralNetwork.hpp"
+#include "./SparseLayers.hpp"
+
+//
+//
+// SPARSE NET
+
+// Inference only copy of a pruned NeuralNetwork, see Pruner.
+//
+// Each layer is stored in CSR -> the zeroed weights cost neither memory
+// nor multiplications. Same outputs as the dense network it was built from.
+
+class SparseNeuralNetwork
+{
+private: // attr
+    SparseLayers m_arr_layers;
+    std::vector<t_vals> m_arr_activations; // inputs, then the outputs of each layer
+
+public: // ctor/dtor
+    SparseNeuralNetwork(const NeuralNetwork& network);
+
+public: // public method(s)
+    void feedForward(const t_vals &inputVals);
+    void getResults(t_vals &resultVals) const;
+
+public: // getter/setter
+    uint64_t getTotalNonZeros(void) const;
+    std::size_t getMemoryBytes(void) const;
+    inline const SparseLayers& getLayers(void) const { return m_arr_layers; }
+};
+
+// SPARSE NET
+//
+//
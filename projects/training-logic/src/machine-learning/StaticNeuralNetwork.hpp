@@ -0,0 +1,271 @@
+
+#pragma once
+
+#include "./NeuralNetwork.hpp"
+#include "./ActivationFunctions.hpp"
+
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <utility>
+
+//
+//
+// STATIC NET
+
+// Same network as NeuralNetwork, with the topology fixed at compile time,
+// e.g. StaticNeuralNetwork<2, 4, 1> for the gate networks.
+//
+// Everything is stored in std::array, the weights use the flat layout of
+// NeuralNetwork::getWeights() and every loop has a compile-time bound
+// -> no allocation and no indirection, tiny models are only register math.
+// The sums are done in the same order as Neuron -> same results.
+
+template <uint32_t... t_Sizes>
+class StaticNeuralNetwork
+{
+    static_assert(sizeof...(t_Sizes) >= 2, "need at least an input and an output layer");
+    static_assert(((t_Sizes > 0) && ...), "no empty layer");
+
+private: // static attr -> topology
+    static constexpr uint32_t k_totalLayers = sizeof...(t_Sizes);
+    static constexpr std::array<uint32_t, k_totalLayers> k_topology = {{ t_Sizes... }};
+
+    static constexpr uint32_t k_numInputs = k_topology.front();
+    static constexpr uint32_t k_numOutputs = k_topology.back();
+
+    // offset of the first neuron of each layer in m_arr_outputs (bias neurons excluded)
+    static constexpr std::array<uint32_t, k_totalLayers + 1> k_neuronOffsets = []() {
+        std::array<uint32_t, k_totalLayers + 1> arr_offsets = {};
+        for (uint32_t ii = 0; ii < k_totalLayers; ++ii)
+            arr_offsets[ii + 1] = arr_offsets[ii] + k_topology[ii];
+        return arr_offsets;
+    }();
+
+    // offset of the weights between the layers ii and ii + 1
+    static constexpr std::array<uint32_t, k_totalLayers> k_weightOffsets = []() {
+        std::array<uint32_t, k_totalLayers> arr_offsets = {};
+        for (uint32_t ii = 0; ii + 1 < k_totalLayers; ++ii)
+            arr_offsets[ii + 1] = arr_offsets[ii] + k_topology[ii + 1] * (k_topology[ii] + 1);
+        return arr_offsets;
+    }();
+
+    static constexpr uint32_t k_totalNeurons = k_neuronOffsets.back();
+    static constexpr uint32_t k_totalWeights = k_weightOffsets.back();
+
+    static constexpr double k_recentAvgSmoothingFactor = 100.0; // same as NeuralNetwork
+
+private: // attr
+    std::array<double, k_totalWeights> m_arr_weights = {};
+    std::array<double, k_totalNeurons> m_arr_outputs = {};
+    std::array<double, k_totalNeurons> m_arr_gradients = {}; // used by the backpropagation
+
+private: // attr -> error
+    double m_error = 0.0;
+    double m_recentAvgError = 0.0;
+
+public: // ctor/dtor
+    StaticNeuralNetwork() = default;
+
+    explicit StaticNeuralNetwork(const NeuralNetwork& network)
+    {
+        loadWeights(network);
+    }
+
+public: // public method(s)
+    // copy the weights of a dynamic network of the same topology
+    void loadWeights(const NeuralNetwork& network)
+    {
+        std::vector<uint32_t> arr_topology;
+        network.getTopology(arr_topology);
+        assert( arr_topology.size() == k_totalLayers );
+        assert( std::equal(arr_topology.begin(), arr_topology.end(), k_topology.begin()) );
+
+        t_vals arr_weights;
+        network.getWeights(arr_weights);
+        assert( arr_weights.size() == k_totalWeights );
+
+        std::copy(arr_weights.begin(), arr_weights.end(), m_arr_weights.begin());
+    }
+
+    void saveWeights(NeuralNetwork& network) const
+    {
+        network.setWeights(t_vals(m_arr_weights.begin(), m_arr_weights.end()));
+    }
+
+    void feedForward(const std::array<double, k_numInputs>& arr_inputVals)
+    {
+        // Assign (latch) the input values into the input neurons
+        for (uint32_t ii = 0; ii < k_numInputs; ++ii)
+            m_arr_outputs[ii] = arr_inputVals[ii];
+
+        _feedForwardLayers(std::make_index_sequence<k_totalLayers - 1>());
+    }
+
+    void feedForward(const t_vals& arr_inputVals)
+    {
+        assert( arr_inputVals.size() == k_numInputs );
+
+        for (uint32_t ii = 0; ii < k_numInputs; ++ii)
+            m_arr_outputs[ii] = arr_inputVals[ii];
+
+        _feedForwardLayers(std::make_index_sequence<k_totalLayers - 1>());
+    }
+
+    void backProp(const std::array<double, k_numOutputs>& arr_targetVals)
+    {
+        _backProp(arr_targetVals.data());
+    }
+
+    void backProp(const t_vals& arr_targetVals)
+    {
+        assert( arr_targetVals.size() == k_numOutputs );
+
+        _backProp(arr_targetVals.data());
+    }
+
+    void getResults(std::array<double, k_numOutputs>& arr_resultVals) const
+    {
+        constexpr uint32_t outputOffset = k_neuronOffsets[k_totalLayers - 1];
+
+        for (uint32_t ii = 0; ii < k_numOutputs; ++ii)
+            arr_resultVals[ii] = m_arr_outputs[outputOffset + ii];
+    }
+
+    void getResults(t_vals& arr_resultVals) const
+    {
+        constexpr uint32_t outputOffset = k_neuronOffsets[k_totalLayers - 1];
+
+        arr_resultVals.assign(
+            m_arr_outputs.begin() + outputOffset,
+            m_arr_outputs.begin() + outputOffset + k_numOutputs);
+    }
+
+public: // public method(s) -> error
+    inline double getError(void) const { return m_error; }
+    inline double getRecentAverageError(void) const { return m_recentAvgError; }
+
+private: // private method(s)
+    template <std::size_t... t_Layers>
+    inline void _feedForwardLayers(std::index_sequence<t_Layers...>)
+    {
+        (_feedForwardLayer<uint32_t(t_Layers) + 1>(), ...);
+    }
+
+    template <uint32_t t_Layer>
+    inline void _feedForwardLayer()
+    {
+        constexpr uint32_t numInputs = k_topology[t_Layer - 1];
+        constexpr uint32_t numOutputs = k_topology[t_Layer];
+        constexpr uint32_t rowSize = numInputs + 1;
+
+        const double* inputs = m_arr_outputs.data() + k_neuronOffsets[t_Layer - 1];
+        double* outputs = m_arr_outputs.data() + k_neuronOffsets[t_Layer];
+        const double* weights = m_arr_weights.data() + k_weightOffsets[t_Layer - 1];
+
+        for (uint32_t jj = 0; jj < numOutputs; ++jj)
+        {
+            const double* row = weights + jj * rowSize;
+
+            double sum = 0.0;
+            for (uint32_t ii = 0; ii < numInputs; ++ii)
+                sum += inputs[ii] * row[ii];
+            sum += 1.0 * row[numInputs]; // bias neuron, last as in Neuron::feedForward
+
+            outputs[jj] = ActivationFunctions::current::activation(sum);
+        }
+    }
+
+    template <std::size_t... t_Layers>
+    inline void _calcHiddenGradientsLayers(std::index_sequence<t_Layers...>)
+    {
+        // from the last hidden layer to the first one
+        (_calcHiddenGradientsLayer<uint32_t(k_totalLayers - 2 - t_Layers)>(), ...);
+    }
+
+    template <uint32_t t_Layer>
+    inline void _calcHiddenGradientsLayer()
+    {
+        constexpr uint32_t numNeurons = k_topology[t_Layer];
+        constexpr uint32_t numNext = k_topology[t_Layer + 1];
+        constexpr uint32_t rowSize = numNeurons + 1;
+
+        const double* outputs = m_arr_outputs.data() + k_neuronOffsets[t_Layer];
+        double* gradients = m_arr_gradients.data() + k_neuronOffsets[t_Layer];
+        const double* nextGradients = m_arr_gradients.data() + k_neuronOffsets[t_Layer + 1];
+        const double* weights = m_arr_weights.data() + k_weightOffsets[t_Layer];
+
+        for (uint32_t ii = 0; ii < numNeurons; ++ii)
+        {
+            // Sum our contributions of the errors at the nodes we feed.
+            double dow = 0.0;
+            for (uint32_t jj = 0; jj < numNext; ++jj)
+                dow += weights[jj * rowSize + ii] * nextGradients[jj];
+
+            gradients[ii] = dow * ActivationFunctions::current::derivative(outputs[ii]);
+        }
+    }
+
+    template <std::size_t... t_Layers>
+    inline void _updateWeightsLayers(std::index_sequence<t_Layers...>, double learningRate)
+    {
+        (_updateWeightsLayer<uint32_t(t_Layers) + 1>(learningRate), ...);
+    }
+
+    template <uint32_t t_Layer>
+    inline void _updateWeightsLayer(double learningRate)
+    {
+        constexpr uint32_t numInputs = k_topology[t_Layer - 1];
+        constexpr uint32_t numOutputs = k_topology[t_Layer];
+        constexpr uint32_t rowSize = numInputs + 1;
+
+        const double* inputs = m_arr_outputs.data() + k_neuronOffsets[t_Layer - 1];
+        const double* gradients = m_arr_gradients.data() + k_neuronOffsets[t_Layer];
+        double* weights = m_arr_weights.data() + k_weightOffsets[t_Layer - 1];
+
+        for (uint32_t jj = 0; jj < numOutputs; ++jj)
+        {
+            double* row = weights + jj * rowSize;
+
+            for (uint32_t ii = 0; ii < numInputs; ++ii)
+                row[ii] += learningRate * inputs[ii] * gradients[jj];
+            row[numInputs] += learningRate * 1.0 * gradients[jj]; // bias neuron
+        }
+    }
+
+    void _backProp(const double* targetVals)
+    {
+        constexpr uint32_t outputOffset = k_neuronOffsets[k_totalLayers - 1];
+
+        const double* outputs = m_arr_outputs.data() + outputOffset;
+        double* gradients = m_arr_gradients.data() + outputOffset;
+
+        //
+        // error (RMS of output neuron errors) and output gradients
+
+        m_error = 0.0;
+        for (uint32_t ii = 0; ii < k_numOutputs; ++ii)
+        {
+            const double delta = targetVals[ii] - outputs[ii];
+            m_error += delta * delta;
+
+            gradients[ii] = ActivationFunctions::outputGradient(outputs[ii], targetVals[ii]);
+        }
+        m_error /= k_numOutputs; // get average error squared
+        m_error = std::sqrt(m_error); // RMS
+
+        m_recentAvgError =
+                (m_recentAvgError * k_recentAvgSmoothingFactor + m_error)
+                / (k_recentAvgSmoothingFactor + 1.0);
+
+        //
+        // hidden gradients, then the weights (gradients use the old weights)
+
+        _calcHiddenGradientsLayers(std::make_index_sequence<k_totalLayers - 2>());
+        _updateWeightsLayers(std::make_index_sequence<k_totalLayers - 1>(), Neuron::getLearningRate());
+    }
+};
+
+// STATIC NET
+//
+//
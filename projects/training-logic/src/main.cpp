@@ -4,14 +4,18 @@
 
 
 #include "./machine-learning/NeuralNetwork.hpp"
+#include "./machine-learning/Checkpointer.hpp"
 
-#include "./utilities/TrainingData.hpp"
+#include "./utilities/ISampleSource.hpp"
 #include "./utilities/RandomNumberGenerator.hpp"
+#include "./utilities/ThreadPool.hpp"
 
 #include <iostream>
 #include <iomanip>
 #include <cassert>
 #include <array>
+#include <memory>
+#include <stdexcept>
 
 
 
@@ -40,41 +44,152 @@ void showVectorVals(const std::string& prefix, const t_vals &arr_values)
 
 void printUsageAndExit(const char* programName)
 {
-	std::cerr << "Usage: " << programName << " TRAINING_DATA_FILENAME" << std::endl;
+	std::cerr << "Usage: " << programName << " TRAINING_DATA [SEED] [--checkpoint CHECKPOINT_FILENAME] [--threads N]" << std::endl;
+	std::cerr << "  TRAINING_DATA: text file, binary file (*.bin) or synthetic:GATE[:INPUTS[:SAMPLES[:SEED]]]" << std::endl;
+	std::cerr << "  --threads N: split the wide layers of each sample across N threads (default 1)" << std::endl;
 	exit(EXIT_FAILURE);
 }
 
+// digits only and at most maxValue, otherwise the usage
+// -> std::stoul alone aborts on "abc" and silently accepts "-1" or "12abc"
+uint64_t parseUnsignedOrExit(const char* programName, const std::string& value, uint64_t maxValue = UINT32_MAX)
+{
+    if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos)
+        printUsageAndExit(programName);
+
+    uint64_t result = 0;
+    try
+    {
+        result = std::stoull(value);
+    }
+    catch (const std::out_of_range&)
+    {
+        printUsageAndExit(programName);
+    }
+
+    if (result > maxValue)
+        printUsageAndExit(programName);
+
+    return result;
+}
+
+namespace {
+    const int32_t k_checkpointInterval = 500; // training passes between two checkpoints
+}
+
 
 int main(int argc, char** argv)
 {
-    if (argc != 2) {
+    std::vector<std::string> arr_arguments;
+    std::string checkpointFilename;
+    uint32_t totalThreads = 1;
+
+    for (int ii = 1; ii < argc; ++ii)
+    {
+        const std::string argument = argv[ii];
+
+        if (argument == "--checkpoint")
+        {
+            if (ii + 1 >= argc)
+                printUsageAndExit(argv[0]);
+            checkpointFilename = argv[++ii];
+        }
+        else if (argument == "--threads")
+        {
+            if (ii + 1 >= argc)
+                printUsageAndExit(argv[0]);
+            totalThreads = uint32_t(parseUnsignedOrExit(argv[0], argv[++ii]));
+            if (totalThreads == 0)
+                printUsageAndExit(argv[0]);
+        }
+        else
+        {
+            arr_arguments.push_back(argument);
+        }
+    }
+
+    if (arr_arguments.size() != 1 && arr_arguments.size() != 2) {
 		printUsageAndExit(argv[0]);
 	}
 
-    const std::string trainingFilename = argv[1];
+    const std::string trainingData = arr_arguments[0];
 
-    TrainingData trainData(trainingFilename);
+    // same seed -> same initial weights -> same run
+    uint32_t seed = (arr_arguments.size() == 2)
+        ? uint32_t(parseUnsignedOrExit(argv[0], arr_arguments[1]))
+        : RandomNumberGenerator::getClockSeed();
+
+    // the generated samples follow the seed of the run, unless the description has its own
+    uint32_t dataSeed = seed;
+
+    // resume from the latest checkpoint, if any
+    CheckpointState checkpoint;
+    const bool isResuming = !checkpointFilename.empty() && Checkpointer::load(checkpointFilename, checkpoint);
+
+    if (isResuming)
+    {
+        seed = checkpoint.seed;
+        dataSeed = checkpoint.dataSeed;
+    }
+
+    std::unique_ptr<ISampleSource> sampleSource = ISampleSource::create(trainingData, dataSeed);
 
     // e.g., { 2, 3, 1 }
     std::vector<uint32_t> arr_topology;
-    trainData.getTopology(arr_topology);
+    sampleSource->getTopology(arr_topology);
+
+    if (isResuming && checkpoint.arr_topology != arr_topology)
+    {
+        std::cerr << "The checkpoint topology does not match the training data" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    NeuralNetwork myNet(arr_topology, seed);
 
-    NeuralNetwork myNet(arr_topology);
+    // intra-layer parallelism, same results whatever the number of threads
+    ThreadPool threadPool(totalThreads);
+    if (totalThreads > 1)
+        myNet.setThreadPool(&threadPool);
+    std::cout << "Seed: " << myNet.getSeed() << "\n";
+
+    int32_t trainingPass = 0;
+
+    if (isResuming)
+    {
+        Checkpointer::restore(checkpoint, myNet);
+
+        try
+        {
+            sampleSource->setPosition(checkpoint.dataPosition);
+        }
+        catch (const std::out_of_range&)
+        {
+            std::cerr << "The checkpoint position is past the end of the training data" << std::endl;
+            return EXIT_FAILURE;
+        }
+        trainingPass = int32_t(checkpoint.trainingPass);
+
+        std::cout << "Resumed from: " << checkpointFilename << " (trainingPass: " << trainingPass << ")\n";
+    }
+
+    std::unique_ptr<Checkpointer> checkpointer;
+    if (!checkpointFilename.empty())
+        checkpointer = std::make_unique<Checkpointer>(checkpointFilename);
 
     t_vals arr_inputVals;
     t_vals arr_targetVals;
     t_vals arr_resultVals;
-    int32_t trainingPass = 0;
 
-    while (!trainData.isEof())
+    for (;;)
     {
+        // Get new input data and what the outputs should be:
+        if (!sampleSource->getNextSample(arr_inputVals, arr_targetVals))
+            break;
+
         ++trainingPass;
         std::cout << "\nPass " << trainingPass << "\n";
 
-        // Get new input data and feed it forward:
-        if (trainData.getNextInputs(arr_inputVals) != arr_topology[0])
-            break;
-
+        // Feed the inputs forward:
         showVectorVals("Inputs:", arr_inputVals);
         myNet.feedForward(arr_inputVals);
 
@@ -83,7 +198,6 @@ int main(int argc, char** argv)
         showVectorVals("Outputs:", arr_resultVals);
 
         // Train the net what the outputs should have been:
-        trainData.getTargetOutputs(arr_targetVals);
         showVectorVals("Targets:", arr_targetVals);
         assert(arr_targetVals.size() == arr_topology.back());
 
@@ -93,6 +207,10 @@ int main(int argc, char** argv)
         std::cout << "Net current error: " << myNet.getError() << "\n";
         std::cout << "Net recent average error: " << myNet.getRecentAverageError() << std::endl;
 
+        // only a copy here, the file is written in the background
+        if (checkpointer && trainingPass % k_checkpointInterval == 0)
+            checkpointer->requestSave(myNet, sampleSource->getPosition(), sampleSource->getSeed(), uint64_t(trainingPass));
+
         if (
             // we need enough sample data for the average, here 100 samples
             trainingPass > 100 &&
@@ -0,0 +1,181 @@
+
+#include "./BinaryFileSampleSource.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+    const char k_magic[8] = { 'N', 'N', 'S', 'M', 'P', 'L', '0', '1' };
+
+    template <typename T>
+    bool readValue(std::ifstream &file, T &value)
+    {
+        return bool(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+    template <typename T>
+    void writeValue(std::ofstream &file, const T &value)
+    {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+}
+
+BinaryFileSampleSource::BinaryFileSampleSource(const std::string &filename)
+{
+    m_file.open(filename.c_str(), std::ios::binary);
+
+    if (m_file.fail()) {
+        throw std::invalid_argument("file not found");
+    }
+
+    char magic[sizeof(k_magic)];
+    uint32_t totalLayers = 0;
+
+    if (!m_file.read(magic, sizeof(magic)) ||
+        std::memcmp(magic, k_magic, sizeof(k_magic)) != 0 ||
+        !readValue(m_file, totalLayers) ||
+        totalLayers < 2) {
+        throw std::invalid_argument("not a binary sample file");
+    }
+
+    m_arr_topology.resize(totalLayers);
+    for (uint32_t &layerSize : m_arr_topology)
+    {
+        if (!readValue(m_file, layerSize))
+            throw std::invalid_argument("not a binary sample file");
+    }
+
+    if (!readValue(m_file, m_totalSamples))
+        throw std::invalid_argument("not a binary sample file");
+
+    m_dataOffset = m_file.tellg();
+    m_endSample = m_totalSamples;
+}
+
+void BinaryFileSampleSource::getTopology(std::vector<uint32_t> &arr_topology) const
+{
+    arr_topology = m_arr_topology;
+}
+
+bool BinaryFileSampleSource::getNextSample(t_vals &arr_inputVals, t_vals &arr_targetVals)
+{
+    if (m_nextSample >= m_endSample)
+        return false;
+
+    arr_inputVals.resize(m_arr_topology.front());
+    arr_targetVals.resize(m_arr_topology.back());
+
+    if (!m_file.read(reinterpret_cast<char*>(arr_inputVals.data()), std::streamsize(arr_inputVals.size() * sizeof(double))) ||
+        !m_file.read(reinterpret_cast<char*>(arr_targetVals.data()), std::streamsize(arr_targetVals.size() * sizeof(double))))
+        return false;
+
+    ++m_nextSample;
+    return true;
+}
+
+uint32_t BinaryFileSampleSource::getNextBatch(
+    uint32_t maxSamples,
+    std::vector<t_vals> &arr_inputs, std::vector<t_vals> &arr_targets)
+{
+    const uint32_t numInputs = m_arr_topology.front();
+    const uint32_t numOutputs = m_arr_topology.back();
+    const uint32_t sampleSize = numInputs + numOutputs;
+
+    // a position set past the end of the shard -> nothing left
+    const uint64_t remainingSamples = (m_nextSample < m_endSample) ? (m_endSample - m_nextSample) : 0;
+    const uint32_t totalSamples = uint32_t(std::min<uint64_t>(maxSamples, remainingSamples));
+
+    // one read for the whole batch
+    m_arr_buffer.resize(std::size_t(totalSamples) * sampleSize);
+    if (!m_file.read(reinterpret_cast<char*>(m_arr_buffer.data()), std::streamsize(m_arr_buffer.size() * sizeof(double))))
+    {
+        arr_inputs.clear();
+        arr_targets.clear();
+        return 0;
+    }
+
+    m_nextSample += totalSamples;
+
+    arr_inputs.resize(totalSamples);
+    arr_targets.resize(totalSamples);
+
+    for (uint32_t ii = 0; ii < totalSamples; ++ii)
+    {
+        const double* sample = m_arr_buffer.data() + std::size_t(ii) * sampleSize;
+
+        arr_inputs[ii].assign(sample, sample + numInputs);
+        arr_targets[ii].assign(sample + numInputs, sample + sampleSize);
+    }
+
+    return totalSamples;
+}
+
+uint64_t BinaryFileSampleSource::getPosition(void)
+{
+    return m_nextSample;
+}
+
+void BinaryFileSampleSource::setPosition(uint64_t position)
+{
+    const uint32_t sampleSize = m_arr_topology.front() + m_arr_topology.back();
+
+    m_nextSample = std::min(position, m_totalSamples);
+
+    m_file.clear(); // reset the eof flag
+    m_file.seekg(m_dataOffset + std::streamoff(m_nextSample * sampleSize * sizeof(double)));
+}
+
+bool BinaryFileSampleSource::setShard(uint32_t shardIndex, uint32_t totalShards)
+{
+    if (totalShards == 0 || shardIndex >= totalShards)
+        return false;
+
+    const uint64_t firstSample = m_nextSample;
+    const uint64_t totalSamples = m_endSample - firstSample;
+
+    m_endSample = firstSample + totalSamples * (shardIndex + 1) / totalShards;
+    setPosition(firstSample + totalSamples * shardIndex / totalShards);
+    return true;
+}
+
+uint64_t BinaryFileSampleSource::save(ISampleSource &source, const std::string &filename)
+{
+    std::ofstream file(filename.c_str(), std::ios::binary | std::ios::trunc);
+
+    if (file.fail()) {
+        throw std::invalid_argument("cannot write file");
+    }
+
+    std::vector<uint32_t> arr_topology;
+    source.getTopology(arr_topology);
+
+    file.write(k_magic, sizeof(k_magic));
+    writeValue(file, uint32_t(arr_topology.size()));
+    for (uint32_t layerSize : arr_topology)
+        writeValue(file, layerSize);
+
+    // the count is only known at the end, patched below
+    const std::streamoff countOffset = file.tellp();
+    writeValue(file, uint64_t(0));
+
+    t_vals arr_inputVals;
+    t_vals arr_targetVals;
+    uint64_t totalSamples = 0;
+
+    while (source.getNextSample(arr_inputVals, arr_targetVals))
+    {
+        file.write(reinterpret_cast<const char*>(arr_inputVals.data()), std::streamsize(arr_inputVals.size() * sizeof(double)));
+        file.write(reinterpret_cast<const char*>(arr_targetVals.data()), std::streamsize(arr_targetVals.size() * sizeof(double)));
+        ++totalSamples;
+    }
+
+    file.seekp(countOffset);
+    writeValue(file, totalSamples);
+
+    if (file.fail()) {
+        throw std::runtime_error("failed to write file");
+    }
+
+    return totalSamples;
+}
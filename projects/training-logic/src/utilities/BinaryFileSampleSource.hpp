@@ -0,0 +1,45 @@
+
+#pragma once
+
+#include "./ISampleSource.hpp"
+
+#include <fstream>
+
+// Raw doubles, no parsing:
+// -> header: "NNSMPL01", layer count (u32), topology (u32 each), sample count (u64)
+// -> then per sample: the inputs, then the targets (f64 each)
+
+class BinaryFileSampleSource : public ISampleSource
+{
+private: // attr
+    std::ifstream m_file;
+    std::vector<uint32_t> m_arr_topology;
+    uint64_t m_totalSamples = 0;
+    uint64_t m_nextSample = 0;
+    uint64_t m_endSample = 0; // of the shard, see setShard
+    std::streamoff m_dataOffset = 0; // first sample in the file
+    t_vals m_arr_buffer; // read a whole batch at once
+
+public: // ctor/dtor
+    BinaryFileSampleSource(const std::string &filename);
+
+public: // public method(s)
+    void getTopology(std::vector<uint32_t> &arr_topology) const override;
+    bool getNextSample(t_vals &arr_inputVals, t_vals &arr_targetVals) override;
+    uint32_t getNextBatch(
+        uint32_t maxSamples,
+        std::vector<t_vals> &arr_inputs, std::vector<t_vals> &arr_targets) override;
+
+    // the sample index
+    uint64_t getPosition(void) override;
+    void setPosition(uint64_t position) override;
+
+    bool setShard(uint32_t shardIndex, uint32_t totalShards) override;
+
+public: // getter/setter
+    inline uint64_t getTotalSamples(void) const { return m_totalSamples; }
+
+public: // static method(s)
+    // write what is left in the source, return the number of samples written
+    static uint64_t save(ISampleSource &source, const std::string &filename);
+};
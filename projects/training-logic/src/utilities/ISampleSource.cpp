@@ -0,0 +1,63 @@
+
+#include "./ISampleSource.hpp"
+
+#include "./TextFileSampleSource.hpp"
+#include "./BinaryFileSampleSource.hpp"
+#include "./SyntheticGateSampleSource.hpp"
+
+#include <sstream>
+
+uint32_t ISampleSource::getNextBatch(
+    uint32_t maxSamples,
+    std::vector<t_vals> &arr_inputs, std::vector<t_vals> &arr_targets)
+{
+    // only grow -> the inner vectors keep their capacity from batch to batch
+    if (arr_inputs.size() < maxSamples)
+        arr_inputs.resize(maxSamples);
+    if (arr_targets.size() < maxSamples)
+        arr_targets.resize(maxSamples);
+
+    uint32_t totalSamples = 0;
+    while (totalSamples < maxSamples && getNextSample(arr_inputs[totalSamples], arr_targets[totalSamples]))
+        ++totalSamples;
+
+    arr_inputs.resize(totalSamples);
+    arr_targets.resize(totalSamples);
+    return totalSamples;
+}
+
+std::unique_ptr<ISampleSource> ISampleSource::create(const std::string &description, uint32_t defaultSeed)
+{
+    const std::string syntheticPrefix = "synthetic:";
+
+    if (description.rfind(syntheticPrefix, 0) == 0)
+    {
+        std::stringstream sstr(description.substr(syntheticPrefix.size()));
+
+        std::string gateName;
+        std::string value;
+        uint32_t numInputs = 2;
+        uint64_t totalSamples = 2000; // same as the training-data-generator
+        uint32_t seed = defaultSeed;
+
+        std::getline(sstr, gateName, ':');
+        if (std::getline(sstr, value, ':'))
+            numInputs = uint32_t(std::stoul(value));
+        if (std::getline(sstr, value, ':'))
+            totalSamples = std::stoull(value);
+        if (std::getline(sstr, value, ':'))
+            seed = uint32_t(std::stoul(value));
+
+        return std::make_unique<SyntheticGateSampleSource>(gateName, numInputs, totalSamples, seed);
+    }
+
+    const std::string binaryExtension = ".bin";
+
+    if (description.size() > binaryExtension.size() &&
+        description.compare(description.size() - binaryExtension.size(), binaryExtension.size(), binaryExtension) == 0)
+    {
+        return std::make_unique<BinaryFileSampleSource>(description);
+    }
+
+    return std::make_unique<TextFileSampleSource>(description);
+}
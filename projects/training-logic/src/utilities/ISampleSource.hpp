@@ -0,0 +1,56 @@
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Where the trainer pulls its samples from: a text file, a binary file or
+// an in-process generator -> the synthetic workloads skip the I/O and the
+// text parsing entirely.
+
+using t_vals = std::vector<double>;
+
+class ISampleSource
+{
+public: // ctor/dtor
+    virtual ~ISampleSource() = default;
+
+public: // public method(s)
+    virtual void getTopology(std::vector<uint32_t> &arr_topology) const = 0;
+
+    // return false once the source is exhausted
+    virtual bool getNextSample(t_vals &arr_inputVals, t_vals &arr_targetVals) = 0;
+
+    // fill up to maxSamples (the inner vectors are reused), return how many were read
+    virtual uint32_t getNextBatch(
+        uint32_t maxSamples,
+        std::vector<t_vals> &arr_inputs, std::vector<t_vals> &arr_targets);
+
+public: // public method(s) -> resume from a checkpoint
+    // opaque, only meaningful to the same kind of source
+    // -> setPosition() throw std::out_of_range if the source can't go there
+    virtual uint64_t getPosition(void) = 0;
+    virtual void setPosition(uint64_t position) = 0;
+
+    // what the samples are generated from, 0 for the files
+    // -> give it back to create() to get the same samples again
+    virtual uint32_t getSeed(void) const { return 0; }
+
+public: // public method(s) -> data parallelism
+    // only keep the shard shardIndex out of totalShards, from the current position:
+    // -> the files: a contiguous range of their samples
+    // -> the generators: their share of the samples, from a seed of their own,
+    //    only on a fresh source (see SyntheticGateSampleSource::setShard)
+    // a shard can be empty, when there are fewer samples than shards
+    // return false if this source can't be split
+    virtual bool setShard(uint32_t shardIndex, uint32_t totalShards) { (void)shardIndex; (void)totalShards; return false; }
+
+public: // static method(s)
+    // "synthetic:GATE[:INPUTS[:SAMPLES[:SEED]]]" -> SyntheticGateSampleSource
+    // -> no SEED: seeded with defaultSeed, e.g. the seed of the run
+    // "FILENAME.bin" -> BinaryFileSampleSource
+    // otherwise -> TextFileSampleSource
+    static std::unique_ptr<ISampleSource> create(const std::string &description, uint32_t defaultSeed);
+};
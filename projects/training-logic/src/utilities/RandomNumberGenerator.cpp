@@ -2,13 +2,33 @@
 #include "./RandomNumberGenerator.hpp"
 
 #include <chrono>
+#include <sstream>
 
-void RandomNumberGenerator::setSeed(uint32_t seed) { _engine.seed(seed); }
+RandomNumberGenerator::RandomNumberGenerator(uint32_t seed) : _engine(seed) {}
 
-void RandomNumberGenerator::ensureRandomSeed() {
+uint32_t RandomNumberGenerator::getClockSeed() {
   auto currTime = std::chrono::high_resolution_clock::now();
   auto seed = currTime.time_since_epoch().count();
-  _engine.seed(uint32_t(seed));
+  return uint32_t(seed);
+}
+
+void RandomNumberGenerator::setSeed(uint32_t seed) { _engine.seed(seed); }
+
+uint32_t RandomNumberGenerator::ensureRandomSeed() {
+  const uint32_t seed = getClockSeed();
+  _engine.seed(seed);
+  return seed;
+}
+
+std::string RandomNumberGenerator::getState() const {
+  std::stringstream sstr;
+  sstr << _engine;
+  return sstr.str();
+}
+
+void RandomNumberGenerator::setState(const std::string &state) {
+  std::stringstream sstr(state);
+  sstr >> _engine;
 }
 
 float RandomNumberGenerator::getRangedValue(float min, float max) {
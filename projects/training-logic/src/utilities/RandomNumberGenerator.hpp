@@ -2,14 +2,28 @@
 #pragma once
 
 #include <random>
+#include <string>
 
 class RandomNumberGenerator {
 private:
   std::mt19937 _engine;
 
+public:
+  RandomNumberGenerator() = default;
+  RandomNumberGenerator(uint32_t seed);
+
+public:
+  // a seed taken from the clock, keep it to reproduce the run
+  static uint32_t getClockSeed();
+
 public:
   void setSeed(uint32_t seed);
-  void ensureRandomSeed();
+  uint32_t ensureRandomSeed(); // return the seed used
+
+public:
+  // full engine state, as text -> continue the exact same sequence later
+  std::string getState() const;
+  void setState(const std::string &state);
 
 public:
   float getRangedValue(float min, float max);
@@ -0,0 +1,370 @@
+
+#include "./SocketChannel.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+    const std::string k_unixPrefix = "unix:";
+    const std::string k_tcpPrefix = "tcp:";
+
+    [[noreturn]] void throwError(const std::string& what)
+    {
+        throw std::runtime_error(what + ": " + std::strerror(errno));
+    }
+
+    bool isUnixAddress(const std::string& address)
+    {
+        return address.rfind(k_unixPrefix, 0) == 0;
+    }
+
+    sockaddr_un makeUnixAddress(const std::string& address)
+    {
+        const std::string pathname = address.substr(k_unixPrefix.size());
+
+        sockaddr_un unixAddress;
+        std::memset(&unixAddress, 0, sizeof(unixAddress));
+        unixAddress.sun_family = AF_UNIX;
+
+        if (pathname.size() >= sizeof(unixAddress.sun_path))
+            throw std::invalid_argument("unix socket pathname too long: " + pathname);
+
+        std::memcpy(unixAddress.sun_path, pathname.c_str(), pathname.size() + 1);
+        return unixAddress;
+    }
+
+    // "tcp:HOST:PORT" -> the caller must freeaddrinfo() the result
+    addrinfo* makeTcpAddress(const std::string& address, bool isPassive)
+    {
+        if (address.rfind(k_tcpPrefix, 0) != 0)
+            throw std::invalid_argument("unknown address: " + address);
+
+        const std::string hostAndPort = address.substr(k_tcpPrefix.size());
+        const std::size_t index = hostAndPort.find_last_of(':');
+        if (index == std::string::npos)
+            throw std::invalid_argument("missing port: " + address);
+
+        const std::string host = hostAndPort.substr(0, index);
+        const std::string port = hostAndPort.substr(index + 1);
+
+        addrinfo hints;
+        std::memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = isPassive ? AI_PASSIVE : 0;
+
+        addrinfo* pResult = nullptr;
+        if (getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &pResult) != 0)
+            throw std::invalid_argument("cannot resolve: " + address);
+
+        return pResult;
+    }
+
+    // the gradients are sent as soon as written, not batched by Nagle's algorithm
+    void setNoDelay(int fd)
+    {
+        const int enabled = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enabled, sizeof(enabled));
+    }
+}
+
+//
+//
+// CHANNEL
+
+SocketChannel::SocketChannel(int fd)
+    :   m_fd(fd)
+{
+}
+
+SocketChannel::~SocketChannel()
+{
+    close();
+}
+
+SocketChannel::SocketChannel(SocketChannel&& other) noexcept
+    :   m_fd(other.m_fd)
+{
+    other.m_fd = -1;
+}
+
+SocketChannel& SocketChannel::operator=(SocketChannel&& other) noexcept
+{
+    if (this != &other)
+    {
+        close();
+        m_fd = other.m_fd;
+        other.m_fd = -1;
+    }
+    return *this;
+}
+
+void SocketChannel::sendAll(const void* data, std::size_t size)
+{
+    const char* bytes = static_cast<const char*>(data);
+
+    while (size > 0)
+    {
+        const ssize_t sent = ::send(m_fd, bytes, size, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR)
+            continue;
+        if (sent <= 0)
+            throwError("socket send");
+
+        bytes += sent;
+        size -= std::size_t(sent);
+    }
+}
+
+void SocketChannel::receiveAll(void* data, std::size_t size)
+{
+    if (!tryReceiveAll(data, size))
+        throw std::runtime_error("socket receive: connection closed");
+}
+
+bool SocketChannel::tryReceiveAll(void* data, std::size_t size)
+{
+    char* bytes = static_cast<char*>(data);
+    bool isStarted = false;
+
+    while (size > 0)
+    {
+        const ssize_t received = ::recv(m_fd, bytes, size, 0);
+        if (received < 0 && errno == EINTR)
+            continue;
+        if (received < 0)
+            throwError("socket receive");
+
+        if (received == 0)
+        {
+            if (isStarted)
+                throw std::runtime_error("socket receive: connection closed");
+            return false;
+        }
+
+        isStarted = true;
+        bytes += received;
+        size -= std::size_t(received);
+    }
+    return true;
+}
+
+void SocketChannel::close(void)
+{
+    if (m_fd >= 0)
+    {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+SocketChannel SocketChannel::connect(const std::string& address, double timeoutSeconds)
+{
+    const auto startTime = std::chrono::steady_clock::now();
+
+    for (;;)
+    {
+        int fd = -1;
+        bool isConnected = false;
+
+        if (isUnixAddress(address))
+        {
+            const sockaddr_un unixAddress = makeUnixAddress(address);
+
+            fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd < 0)
+                throwError("socket");
+
+            isConnected = (::connect(fd, reinterpret_cast<const sockaddr*>(&unixAddress), sizeof(unixAddress)) == 0);
+        }
+        else
+        {
+            addrinfo* pAddress = makeTcpAddress(address, false);
+
+            fd = ::socket(pAddress->ai_family, pAddress->ai_socktype, pAddress->ai_protocol);
+            if (fd < 0)
+            {
+                freeaddrinfo(pAddress);
+                throwError("socket");
+            }
+
+            isConnected = (::connect(fd, pAddress->ai_addr, pAddress->ai_addrlen) == 0);
+            freeaddrinfo(pAddress);
+
+            if (isConnected)
+                setNoDelay(fd);
+        }
+
+        if (isConnected)
+            return SocketChannel(fd);
+
+        ::close(fd);
+
+        // the peer is probably not listening yet
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        if (elapsed > timeoutSeconds)
+            throwError("cannot connect to " + address);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+void SocketChannel::exchange(
+    SocketChannel& sendChannel, const void* sendData, std::size_t sendSize,
+    SocketChannel& receiveChannel, void* receiveData, std::size_t receiveSize)
+{
+    const char* sendBytes = static_cast<const char*>(sendData);
+    char* receiveBytes = static_cast<char*>(receiveData);
+
+    while (sendSize > 0 || receiveSize > 0)
+    {
+        pollfd arr_pollFds[2];
+        nfds_t totalFds = 0;
+
+        if (sendSize > 0)
+            arr_pollFds[totalFds++] = { sendChannel.m_fd, POLLOUT, 0 };
+        if (receiveSize > 0)
+            arr_pollFds[totalFds++] = { receiveChannel.m_fd, POLLIN, 0 };
+
+        if (::poll(arr_pollFds, totalFds, -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            throwError("socket poll");
+        }
+
+        for (nfds_t ii = 0; ii < totalFds; ++ii)
+        {
+            if (arr_pollFds[ii].revents == 0)
+                continue;
+
+            // only what fits now, the rest on the next poll
+            if (arr_pollFds[ii].events == POLLOUT)
+            {
+                const ssize_t sent = ::send(sendChannel.m_fd, sendBytes, sendSize, MSG_NOSIGNAL | MSG_DONTWAIT);
+                if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+                    continue;
+                if (sent <= 0)
+                    throwError("socket send");
+
+                sendBytes += sent;
+                sendSize -= std::size_t(sent);
+            }
+            else
+            {
+                const ssize_t received = ::recv(receiveChannel.m_fd, receiveBytes, receiveSize, MSG_DONTWAIT);
+                if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+                    continue;
+                if (received == 0)
+                    throw std::runtime_error("socket receive: connection closed");
+                if (received < 0)
+                    throwError("socket receive");
+
+                receiveBytes += received;
+                receiveSize -= std::size_t(received);
+            }
+        }
+    }
+}
+
+// CHANNEL
+//
+//
+
+
+
+
+
+
+
+
+
+
+
+
+//
+//
+// LISTENER
+
+SocketListener::SocketListener(const std::string& address)
+{
+    if (isUnixAddress(address))
+    {
+        const sockaddr_un unixAddress = makeUnixAddress(address);
+
+        m_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (m_fd < 0)
+            throwError("socket");
+
+        // left over by a previous run
+        m_unixPathname = unixAddress.sun_path;
+        ::unlink(m_unixPathname.c_str());
+
+        if (::bind(m_fd, reinterpret_cast<const sockaddr*>(&unixAddress), sizeof(unixAddress)) != 0)
+            throwError("cannot bind " + address);
+    }
+    else
+    {
+        addrinfo* pAddress = makeTcpAddress(address, true);
+
+        m_fd = ::socket(pAddress->ai_family, pAddress->ai_socktype, pAddress->ai_protocol);
+        if (m_fd < 0)
+        {
+            freeaddrinfo(pAddress);
+            throwError("socket");
+        }
+
+        const int enabled = 1;
+        setsockopt(m_fd, SOL_SOCKET, SO_REUSEADDR, &enabled, sizeof(enabled));
+
+        const bool isBound = (::bind(m_fd, pAddress->ai_addr, pAddress->ai_addrlen) == 0);
+        freeaddrinfo(pAddress);
+
+        if (!isBound)
+            throwError("cannot bind " + address);
+    }
+
+    if (::listen(m_fd, SOMAXCONN) != 0)
+        throwError("cannot listen on " + address);
+}
+
+SocketListener::~SocketListener()
+{
+    if (m_fd >= 0)
+        ::close(m_fd);
+
+    if (!m_unixPathname.empty())
+        ::unlink(m_unixPathname.c_str());
+}
+
+SocketChannel SocketListener::accept(void)
+{
+    for (;;)
+    {
+        const int fd = ::accept(m_fd, nullptr, nullptr);
+        if (fd >= 0)
+        {
+            if (m_unixPathname.empty())
+                setNoDelay(fd);
+            return SocketChannel(fd);
+        }
+
+        if (errno != EINTR)
+            throwError("socket accept");
+    }
+}
+
+// LISTENER
+//
+//
@@ -0,0 +1,67 @@
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Blocking stream socket between two processes.
+//
+// An address is either "unix:PATHNAME" or "tcp:HOST:PORT",
+// every failure throws a std::runtime_error.
+
+class SocketChannel
+{
+private: // attr
+    int m_fd = -1;
+
+public: // ctor/dtor
+    SocketChannel() = default;
+    explicit SocketChannel(int fd);
+    ~SocketChannel();
+
+    SocketChannel(const SocketChannel& other) = delete;
+    SocketChannel& operator=(const SocketChannel& other) = delete;
+
+    SocketChannel(SocketChannel&& other) noexcept;
+    SocketChannel& operator=(SocketChannel&& other) noexcept;
+
+public: // public method(s)
+    void sendAll(const void* data, std::size_t size);
+    void receiveAll(void* data, std::size_t size);
+
+    // false -> the peer closed the connection before sending anything
+    bool tryReceiveAll(void* data, std::size_t size);
+
+    void close(void);
+
+public: // getter/setter
+    inline bool isOpen(void) const { return m_fd >= 0; }
+
+public: // static method(s)
+    // retry until the peer listens, for up to timeoutSeconds
+    static SocketChannel connect(const std::string& address, double timeoutSeconds = 10.0);
+
+    // send to one peer while receiving from another (can be the same one),
+    // -> no deadlock when every process of a ring sends at the same time
+    static void exchange(
+        SocketChannel& sendChannel, const void* sendData, std::size_t sendSize,
+        SocketChannel& receiveChannel, void* receiveData, std::size_t receiveSize);
+};
+
+class SocketListener
+{
+private: // attr
+    int m_fd = -1;
+    std::string m_unixPathname; // removed on destruction
+
+public: // ctor/dtor
+    SocketListener(const std::string& address);
+    ~SocketListener();
+
+    SocketListener(const SocketListener& other) = delete;
+    SocketListener& operator=(const SocketListener& other) = delete;
+
+public: // public method(s)
+    SocketChannel accept(void);
+};
@@ -0,0 +1,63 @@
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <thread>
+#include <cstddef>
+
+// Lock-free single producer / single consumer ring buffer.
+// Only one thread may push and only one (other) thread may pop.
+
+template <typename T, std::size_t Capacity>
+class SpscQueue
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of 2");
+
+private: // attr
+    std::array<T, Capacity> m_arr_items;
+
+    // kept on separate cache lines -> the producer and consumer do not false share
+    alignas(64) std::atomic<std::size_t> m_head{0}; // next item to pop, written by the consumer
+    alignas(64) std::atomic<std::size_t> m_tail{0}; // next slot to push, written by the producer
+
+public: // public method(s)
+    bool tryPush(T&& item)
+    {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+
+        if (tail - m_head.load(std::memory_order_acquire) == Capacity)
+            return false; // full
+
+        m_arr_items[tail & (Capacity - 1)] = std::move(item);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& item)
+    {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+
+        if (head == m_tail.load(std::memory_order_acquire))
+            return false; // empty
+
+        item = std::move(m_arr_items[head & (Capacity - 1)]);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    void push(T&& item)
+    {
+        while (!tryPush(std::move(item)))
+            std::this_thread::yield();
+    }
+
+    void pop(T& item)
+    {
+        while (!tryPop(item))
+            std::this_thread::yield();
+    }
+
+public: // getter/setter
+    static constexpr std::size_t getCapacity(void) { return Capacity; }
+};
@@ -0,0 +1,113 @@
+
+#include "./SyntheticGateSampleSource.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+
+SyntheticGateSampleSource::SyntheticGateSampleSource(
+    const std::string &gateName, uint32_t numInputs, uint64_t totalSamples, uint32_t seed)
+    :   m_totalSamples(totalSamples > 0 ? totalSamples : UINT64_MAX),
+        m_seed(seed),
+        m_rng(seed)
+{
+    if (!getGate(gateName, m_gate)) {
+        throw std::invalid_argument("unknown gate");
+    }
+    if (numInputs == 0) {
+        throw std::invalid_argument("need at least one input");
+    }
+
+    // same shape as the generated files ("topology: 2 4 1" for 2 inputs)
+    m_arr_topology = { numInputs, numInputs * 2, 1 };
+
+    m_arr_bits.resize(numInputs);
+}
+
+void SyntheticGateSampleSource::getTopology(std::vector<uint32_t> &arr_topology) const
+{
+    arr_topology = m_arr_topology;
+}
+
+bool SyntheticGateSampleSource::getNextSample(t_vals &arr_inputVals, t_vals &arr_targetVals)
+{
+    if (m_nextSample >= m_totalSamples)
+        return false;
+
+    arr_inputVals.resize(m_arr_bits.size());
+
+    for (uint32_t ii = 0; ii < m_arr_bits.size(); ++ii)
+    {
+        m_arr_bits[ii] = int(std::round(m_rng.getRangedValue(0.0f, 1.0f)));
+        arr_inputVals[ii] = double(m_arr_bits[ii]);
+    }
+
+    arr_targetVals.resize(1);
+    arr_targetVals[0] = double(m_gate(m_arr_bits)); // should be 0 or 1
+
+    ++m_nextSample;
+    return true;
+}
+
+uint64_t SyntheticGateSampleSource::getPosition(void)
+{
+    return m_nextSample;
+}
+
+void SyntheticGateSampleSource::setPosition(uint64_t position)
+{
+    // replay the generator up to the position
+    m_rng.setSeed(m_seed);
+    m_nextSample = 0;
+
+    t_vals arr_inputVals;
+    t_vals arr_targetVals;
+    while (m_nextSample < position && getNextSample(arr_inputVals, arr_targetVals))
+        ;
+}
+
+bool SyntheticGateSampleSource::setShard(uint32_t shardIndex, uint32_t totalShards)
+{
+    if (totalShards == 0 || shardIndex >= totalShards)
+        return false;
+
+    // the samples already generated came from the seed of the whole source
+    assert( m_nextSample == 0 );
+
+    if (totalShards == 1)
+        return true;
+
+    // split as evenly as possible, a shard can be empty (fewer samples than shards)
+    if (m_totalSamples != UINT64_MAX)
+    {
+        m_totalSamples =
+            m_totalSamples * (shardIndex + 1) / totalShards -
+            m_totalSamples * shardIndex / totalShards;
+    }
+
+    // other samples on each shard, shard 0 keeps the seed
+    m_seed += shardIndex * 0x9E3779B9u;
+    m_rng.setSeed(m_seed);
+    return true;
+}
+
+bool SyntheticGateSampleSource::getGate(const std::string &gateName, t_gate &gate)
+{
+    const auto countSet = [](const std::vector<int> &arr_bits) -> std::size_t {
+        return std::size_t(std::count(arr_bits.begin(), arr_bits.end(), 1));
+    };
+
+    if (gateName == "and")
+        gate = [countSet](const std::vector<int> &arr_bits) -> int { return countSet(arr_bits) == arr_bits.size(); };
+    else if (gateName == "or")
+        gate = [countSet](const std::vector<int> &arr_bits) -> int { return countSet(arr_bits) > 0; };
+    else if (gateName == "no")
+        gate = [countSet](const std::vector<int> &arr_bits) -> int { return countSet(arr_bits) == 0; };
+    else if (gateName == "xor")
+        gate = [countSet](const std::vector<int> &arr_bits) -> int { return countSet(arr_bits) % 2; };
+    else
+        return false;
+
+    return true;
+}
@@ -0,0 +1,51 @@
+
+#pragma once
+
+#include "./ISampleSource.hpp"
+#include "./RandomNumberGenerator.hpp"
+
+#include <functional>
+
+// The gates of the training-data-generator, generalized to N inputs and
+// generated in memory -> no file, no text formatting or parsing.
+// -> "and": all inputs set, "or": any input set,
+//    "no": no input set, "xor": odd number of inputs set
+
+class SyntheticGateSampleSource : public ISampleSource
+{
+public: // external structures
+    using t_gate = std::function<int(const std::vector<int>&)>;
+
+private: // attr
+    t_gate m_gate;
+    std::vector<uint32_t> m_arr_topology;
+    uint64_t m_totalSamples; // UINT64_MAX -> endless, 0 -> empty (a shard can be)
+    uint64_t m_nextSample = 0;
+
+    uint32_t m_seed;
+    RandomNumberGenerator m_rng;
+    std::vector<int> m_arr_bits;
+
+public: // ctor/dtor
+    SyntheticGateSampleSource(
+        const std::string &gateName, uint32_t numInputs, uint64_t totalSamples,
+        uint32_t seed = RandomNumberGenerator::getClockSeed());
+
+public: // public method(s)
+    void getTopology(std::vector<uint32_t> &arr_topology) const override;
+    bool getNextSample(t_vals &arr_inputVals, t_vals &arr_targetVals) override;
+
+    // the sample index, the same samples are generated again from the seed
+    uint64_t getPosition(void) override;
+    void setPosition(uint64_t position) override;
+
+    inline uint32_t getSeed(void) const override { return m_seed; }
+
+    // on a fresh source only (no sample read, no setPosition), the shard has its own seed
+    // -> setPosition() then replays within the shard
+    bool setShard(uint32_t shardIndex, uint32_t totalShards) override;
+
+public: // static method(s)
+    // return false if the gate is unknown
+    static bool getGate(const std::string &gateName, t_gate &gate);
+};
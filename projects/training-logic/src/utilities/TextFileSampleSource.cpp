@@ -0,0 +1,52 @@
+
+#include "./TextFileSampleSource.hpp"
+
+TextFileSampleSource::TextFileSampleSource(const std::string &filename)
+    : m_trainingData(filename)
+{
+    m_trainingData.getTopology(m_arr_topology);
+}
+
+void TextFileSampleSource::getTopology(std::vector<uint32_t> &arr_topology) const
+{
+    arr_topology = m_arr_topology;
+}
+
+bool TextFileSampleSource::getNextSample(t_vals &arr_inputVals, t_vals &arr_targetVals)
+{
+    if (m_trainingData.isEof())
+        return false;
+
+    // past the shard
+    if (m_endPosition != UINT64_MAX && m_trainingData.getPosition() >= m_endPosition)
+        return false;
+
+    if (m_trainingData.getNextInputs(arr_inputVals) != m_arr_topology.front())
+        return false;
+
+    return m_trainingData.getTargetOutputs(arr_targetVals) == m_arr_topology.back();
+}
+
+uint64_t TextFileSampleSource::getPosition(void)
+{
+    return m_trainingData.getPosition();
+}
+
+void TextFileSampleSource::setPosition(uint64_t position)
+{
+    m_trainingData.setPosition(position);
+}
+
+bool TextFileSampleSource::setShard(uint32_t shardIndex, uint32_t totalShards)
+{
+    if (totalShards == 0 || shardIndex >= totalShards)
+        return false;
+
+    const uint64_t firstPosition = m_trainingData.getPosition();
+    const uint64_t totalBytes = m_trainingData.getSize() - firstPosition;
+
+    // the sample starting at the boundary is the first one of the next shard
+    m_endPosition = m_trainingData.findNextSample(firstPosition + totalBytes * (shardIndex + 1) / totalShards);
+    m_trainingData.setPosition(m_trainingData.findNextSample(firstPosition + totalBytes * shardIndex / totalShards));
+    return true;
+}
@@ -0,0 +1,28 @@
+
+#pragma once
+
+#include "./ISampleSource.hpp"
+#include "./TrainingData.hpp"
+
+// the original text format, see TrainingData
+
+class TextFileSampleSource : public ISampleSource
+{
+private: // attr
+    TrainingData m_trainingData;
+    std::vector<uint32_t> m_arr_topology;
+    uint64_t m_endPosition = UINT64_MAX; // of the shard, see setShard
+
+public: // ctor/dtor
+    TextFileSampleSource(const std::string &filename);
+
+public: // public method(s)
+    void getTopology(std::vector<uint32_t> &arr_topology) const override;
+    bool getNextSample(t_vals &arr_inputVals, t_vals &arr_targetVals) override;
+
+    uint64_t getPosition(void) override;
+    void setPosition(uint64_t position) override;
+
+    // byte ranges of the file, each one starts at its first complete sample
+    bool setShard(uint32_t shardIndex, uint32_t totalShards) override;
+};
@@ -0,0 +1,72 @@
+
+#include "./ThreadPool.hpp"
+
+#include <cassert>
+
+ThreadPool::ThreadPool(uint32_t totalThreads)
+    :   m_totalThreads(totalThreads),
+        m_barrier(totalThreads)
+{
+    assert( totalThreads > 0 );
+
+    m_arr_workers.reserve(totalThreads - 1); // pre-allocate
+
+    // index 0 is the calling thread
+    for (uint32_t ii = 1; ii < totalThreads; ++ii)
+    {
+        m_arr_workers.emplace_back(&ThreadPool::_runWorker, this, ii);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    m_stop = true;
+    m_barrier.arrive_and_wait(); // release the workers
+
+    for (std::thread& worker : m_arr_workers)
+    {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallelFor(uint32_t totalItems, const t_task& task)
+{
+    if (m_totalThreads == 1)
+    {
+        task(0, totalItems);
+        return;
+    }
+
+    m_pTask = &task;
+    m_totalItems = totalItems;
+
+    m_barrier.arrive_and_wait(); // start
+    _runChunk(0);
+    m_barrier.arrive_and_wait(); // done
+
+    m_pTask = nullptr;
+}
+
+void ThreadPool::_runWorker(uint32_t threadIndex)
+{
+    for (;;)
+    {
+        m_barrier.arrive_and_wait(); // start
+
+        if (m_stop)
+            return;
+
+        _runChunk(threadIndex);
+
+        m_barrier.arrive_and_wait(); // done
+    }
+}
+
+void ThreadPool::_runChunk(uint32_t threadIndex) const
+{
+    const uint32_t begin = uint64_t(m_totalItems) * threadIndex / m_totalThreads;
+    const uint32_t end = uint64_t(m_totalItems) * (threadIndex + 1) / m_totalThreads;
+
+    if (begin < end)
+        (*m_pTask)(begin, end);
+}
@@ -0,0 +1,49 @@
+
+#pragma once
+
+#include <barrier>
+#include <functional>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+// Persistent workers, synchronized with a barrier at the start and at the
+// end of each parallelFor() -> no thread is spawned per call.
+// Only one thread may call parallelFor() at a time.
+
+class ThreadPool
+{
+public: // external structures
+    // process the range [begin, end)
+    using t_task = std::function<void(uint32_t begin, uint32_t end)>;
+
+private: // attr
+    uint32_t m_totalThreads;
+    std::vector<std::thread> m_arr_workers;
+    std::barrier<> m_barrier;
+
+private: // attr -> current job, read by the workers between the two barriers
+    const t_task* m_pTask = nullptr;
+    uint32_t m_totalItems = 0;
+    bool m_stop = false;
+
+public: // ctor/dtor
+    // totalThreads include the thread calling parallelFor()
+    ThreadPool(uint32_t totalThreads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool& other) = delete;
+    ThreadPool& operator=(const ThreadPool& other) = delete;
+
+public: // public method(s)
+    // split [0, totalItems) in one contiguous chunk per thread,
+    // the calling thread process the first chunk, return once all are done
+    void parallelFor(uint32_t totalItems, const t_task& task);
+
+public: // getter/setter
+    inline uint32_t getTotalThreads(void) const { return m_totalThreads; }
+
+private: // private method(s)
+    void _runWorker(uint32_t threadIndex);
+    void _runChunk(uint32_t threadIndex) const;
+};
@@ -2,6 +2,7 @@
 #include "./TrainingData.hpp"
 
 #include <sstream>
+#include <stdexcept>
 
 TrainingData::TrainingData(const std::string& filename)
 {
@@ -10,6 +11,57 @@ TrainingData::TrainingData(const std::string& filename)
     if (m_file_trainingData.fail()) {
         throw std::invalid_argument("file not found");
     }
+
+    m_file_trainingData.seekg(0, std::ios::end);
+    m_fileSize = uint64_t(m_file_trainingData.tellg());
+    m_file_trainingData.seekg(0);
+}
+
+uint64_t TrainingData::getPosition(void)
+{
+    // -1 once the eof (or fail) flag is set -> everything was read
+    const std::streampos position = m_file_trainingData.tellg();
+    if (position < 0)
+        return m_fileSize;
+
+    return uint64_t(position);
+}
+
+void TrainingData::setPosition(uint64_t position)
+{
+    if (position > m_fileSize)
+        throw std::out_of_range("position past the end of the training data");
+
+    m_file_trainingData.clear(); // reset the eof flag
+    m_file_trainingData.seekg(std::streamoff(position));
+}
+
+uint64_t TrainingData::findNextSample(uint64_t position)
+{
+    std::string str_line;
+
+    // in the middle of a line -> skip to the next one
+    if (position > 0)
+    {
+        setPosition(position - 1);
+        if (m_file_trainingData.get() != '\n')
+            std::getline(m_file_trainingData, str_line);
+    }
+    else
+    {
+        setPosition(0);
+    }
+
+    for (;;)
+    {
+        const uint64_t linePosition = getPosition();
+
+        if (!std::getline(m_file_trainingData, str_line))
+            return getSize();
+
+        if (str_line.rfind("in:", 0) == 0)
+            return linePosition;
+    }
 }
 
 void TrainingData::getTopology(std::vector<unsigned> &arr_topology)
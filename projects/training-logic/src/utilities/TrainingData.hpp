@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <fstream>
+#include <cstdint>
 
 
 // Silly class to read training data from a text file -- Replace This.
@@ -16,6 +17,7 @@ class TrainingData
 {
 private: // attr
     std::ifstream   m_file_trainingData;
+    uint64_t        m_fileSize = 0;
 
 public: // ctor/dtor
     TrainingData(const std::string& filename);
@@ -23,6 +25,18 @@ public: // ctor/dtor
 public: // getter/setter
     inline bool isEof(void) const { return m_file_trainingData.eof(); }
 
+    // offset of the next sample in the file -> resume from a checkpoint
+    // -> the size of the file once it is all read
+    uint64_t getPosition(void);
+    // throw std::out_of_range past the end of the file
+    void setPosition(uint64_t position);
+
+    inline uint64_t getSize(void) const { return m_fileSize; }
+
+    // offset of the first sample ("in:" line) starting at or after position,
+    // the size of the file if there is none
+    uint64_t findNextSample(uint64_t position);
+
 public: // public method(s)
     void getTopology(std::vector<unsigned> &arr_topology);
 
@@ -0,0 +1,36 @@
+#!/bin/sh
+
+ROOTDIR=$PWD
+DATA_GENERATOR_DIR=$ROOTDIR/projects/training-data-generator
+TRAINING_LOGIC_DIR=$ROOTDIR/projects/training-logic
+
+BASELINE_FILE=$TRAINING_LOGIC_DIR/assets/benchmark-baseline.json
+
+#
+#
+# build training-data-generator
+
+cd "$DATA_GENERATOR_DIR" || exit 1
+make all -j4 || exit 1
+cd "$ROOTDIR" || exit 1
+
+#
+#
+# build training-logic (and its benchmark)
+
+cd "$TRAINING_LOGIC_DIR" || exit 1
+make all -j4 || exit 1
+cd "$ROOTDIR" || exit 1
+
+#
+#
+# run, compare against the baseline if there is one, otherwise create it
+# -> extra arguments are given to the benchmark, e.g. --max-samples 100000000
+
+cd "$TRAINING_LOGIC_DIR" || exit 1
+
+if [ -f "$BASELINE_FILE" ]; then
+  ./bin/benchmark --generator "$DATA_GENERATOR_DIR/bin/exec" --baseline "$BASELINE_FILE" "$@" || exit 1
+else
+  ./bin/benchmark --generator "$DATA_GENERATOR_DIR/bin/exec" --output "$BASELINE_FILE" "$@" || exit 1
+fi
@@ -0,0 +1,46 @@
+#!/bin/sh
+
+ROOTDIR=$PWD
+TRAINING_LOGIC_DIR=$ROOTDIR/projects/training-logic
+
+# usage: sh sh_distributed.sh [TOTAL_WORKERS] [ring|ps] [EXTRA ARGUMENTS]
+# -> extra arguments are given to every worker, e.g. --sync-interval 8
+TOTAL_WORKERS=${1:-4}
+SYNC=${2:-ring}
+[ $# -gt 0 ] && shift
+[ $# -gt 0 ] && shift
+
+ADDRESS=unix:/tmp/nn-distributed-$$
+
+#
+#
+# build training-logic (and its distributed workers)
+
+cd "$TRAINING_LOGIC_DIR" || exit 1
+make all -j4 || exit 1
+
+#
+#
+# launch the local processes, the parameter server first if any
+
+PIDS=""
+
+if [ "$SYNC" = "ps" ]; then
+  ./bin/distributed --role server --world-size "$TOTAL_WORKERS" --address "$ADDRESS" &
+  PIDS="$PIDS $!"
+fi
+
+RANK=0
+while [ "$RANK" -lt "$TOTAL_WORKERS" ]; do
+  ./bin/distributed --rank "$RANK" --world-size "$TOTAL_WORKERS" --sync "$SYNC" --address "$ADDRESS" "$@" &
+  PIDS="$PIDS $!"
+  RANK=$((RANK + 1))
+done
+
+# fail if any process failed
+STATUS=0
+for PID in $PIDS; do
+  wait "$PID" || STATUS=1
+done
+
+exit $STATUS